@@ -71,11 +71,25 @@ void UIKAnimInstance::UpdateMovementStates(const float DeltaSeconds)
 {
 	if (Character)
 	{
-		ImpulseMovementMode = Character->GetMyMovementComponent()->ImpulseMovementMode;
+		const FDiscreteMovementState DiscreteState = Character->GetMyMovementComponent()->GetDiscreteMovementState();
+		
+		ImpulseMovementMode = DiscreteState.ImpulseMovementMode;
 		IsInAir = Character->GetMovementComponent()->IsFalling();
-		Jumped = Character->GetMyMovementComponent()->Jumped;
+		
+		// Jumps arrive as events, turn them into a short pulse for the anim graph
+		const uint8 JumpEventCount = DiscreteState.CosmeticEventCounts[EVENT_Jump];
+		const uint8 WallJumpEventCount = DiscreteState.CosmeticEventCounts[EVENT_WallJump];
+		if (JumpEventCount != LastJumpEventCount || WallJumpEventCount != LastWallJumpEventCount)
+			JumpedPulseTime = JumpedPulseDuration;
+		else
+			JumpedPulseTime = FMath::Max(JumpedPulseTime - DeltaSeconds, 0.f);
+		
+		LastJumpEventCount = JumpEventCount;
+		LastWallJumpEventCount = WallJumpEventCount;
+		Jumped = JumpedPulseTime > 0.f;
+		
 		IsCrouching = Character->GetMovementComponent()->IsCrouching();
-		IsSliding = Character->GetMyMovementComponent()->IsSliding;
+		IsSliding = DiscreteState.IsSliding;
 	}
 }
 
@@ -83,7 +97,7 @@ void UIKAnimInstance::UpdateMovementInfo(const float DeltaSeconds)
 {
 	if (Character)
 	{
-		WallRunSide = Character->GetMyMovementComponent()->WallRunSide;
+		WallRunSide = Character->GetMyMovementComponent()->GetDiscreteMovementState().WallRunSide;
 	}
 }
 
@@ -219,7 +233,7 @@ void UIKAnimInstance::UpdateFootIK(const float DeltaSeconds)
 		SetFootLocking(FName("Enable_FootIK_L"), FName("FootLock_L"), FName("ik_foot_l"), LFootLockAlpha, LFootLockLocation, LFootLockRotation, DeltaSeconds);
 		SetFootLocking(FName("Enable_FootIK_R"), FName("FootLock_R"), FName("ik_foot_r"), RFootLockAlpha, RFootLockLocation, RFootLockRotation, DeltaSeconds);
 
-		if (Character->GetMyMovementComponent()->ImpulseMovementMode != CMOVE_InAir)
+		if (ImpulseMovementMode != CMOVE_InAir)
 		{
 			SetFootOffsets(FName("Enable_FootIK_L"), FName("ik_foot_l"), FName("root"), LFootOffsetTarget, LFootOffsetLocation, LFootOffsetRotation, DeltaSeconds);
 			SetFootOffsets(FName("Enable_FootIK_R"), FName("ik_foot_r"), FName("root"), RFootOffsetTarget, RFootOffsetLocation, RFootOffsetRotation, DeltaSeconds);
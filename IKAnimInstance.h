@@ -78,9 +78,20 @@ public:
 	UPROPERTY(BlueprintReadOnly, Category = "Movement States")
 	bool IsInAir;
 
+	/** True for JumpedPulseDuration after the character jumps off the ground or a wall. */
 	UPROPERTY(BlueprintReadOnly, Category = "Movement States")
 	bool Jumped;
 
+	/** How long Jumped stays true after a jump event. */
+	float JumpedPulseDuration = 0.1f;
+
+	/** The time left until Jumped goes back to false. */
+	float JumpedPulseTime = 0.f;
+
+	/** The jump and wall jump event counts of the last update, used to detect new jumps. */
+	uint8 LastJumpEventCount = 0;
+	uint8 LastWallJumpEventCount = 0;
+
 	UPROPERTY(BlueprintReadOnly, Category = "Movement States")
 	bool IsCrouching;
 
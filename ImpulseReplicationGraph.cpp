@@ -0,0 +1,200 @@
+#include "Replication/ImpulseReplicationGraph.h"
+
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/Info.h"
+#include "GameFramework/PlayerController.h"
+#include "Character/Abilities/Movement/GrappleHook.h"
+#include "Character/Abilities/Movement/GrappleHookCable.h"
+
+UImpulseReplicationGraph::UImpulseReplicationGraph()
+{
+	GridNode = nullptr;
+	AlwaysRelevantNode = nullptr;
+}
+
+uint32 UImpulseReplicationGraph::GetReplicationPeriodFrameForFrequency(const float NetUpdateFrequency) const
+{
+	const float ServerTickRate = NetDriver ? NetDriver->GetNetServerMaxTickRate() : 30.f;
+	return FMath::Max<uint32>(FMath::RoundToInt(ServerTickRate / FMath::Max(NetUpdateFrequency, 1.f)), 1);
+}
+
+void UImpulseReplicationGraph::InitGlobalActorClassSettings()
+{
+	Super::InitGlobalActorClassSettings();
+
+	const ACharacter* CharacterCDO = GetDefault<ACharacter>();
+
+	FClassReplicationInfo CharacterInfo;
+	CharacterInfo.DistancePriorityScale = 1.f;
+	CharacterInfo.StarvationPriorityScale = 1.f;
+	CharacterInfo.ActorChannelFrameTimeout = 4;
+	CharacterInfo.ReplicationPeriodFrame = GetReplicationPeriodFrameForFrequency(CharacterCDO->NetUpdateFrequency);
+	CharacterInfo.SetCullDistanceSquared(CharacterCDO->NetCullDistanceSquared);
+
+	GlobalActorReplicationInfoMap.SetClassInfo(ACharacter::StaticClass(), CharacterInfo);
+}
+
+void UImpulseReplicationGraph::InitGlobalGraphNodes()
+{
+	GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+	GridNode->CellSize = GridCellSize;
+	GridNode->SpatialBias = FVector2D(SpatialBiasX, SpatialBiasY);
+	AddGlobalGraphNode(GridNode);
+
+	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+	AddGlobalGraphNode(AlwaysRelevantNode);
+}
+
+void UImpulseReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
+{
+	Super::InitConnectionGraphNodes(RepGraphConnection);
+
+	// Also replicates the player controller, view target and player state of the connection
+	UReplicationGraphNode_AlwaysRelevant_ForConnection* OwnerOnlyNode = CreateNewNode<UReplicationGraphNode_AlwaysRelevant_ForConnection>();
+	AddConnectionGraphNode(OwnerOnlyNode, RepGraphConnection);
+
+	OwnerOnlyNodes.Add(RepGraphConnection, OwnerOnlyNode);
+}
+
+void UImpulseReplicationGraph::RemoveClientConnection(UNetConnection* NetConnection)
+{
+	for (auto It = OwnerOnlyNodes.CreateIterator(); It; ++It)
+	{
+		if (It.Key() == nullptr || It.Key()->NetConnection == NetConnection)
+			It.RemoveCurrent();
+	}
+
+	Super::RemoveClientConnection(NetConnection);
+}
+
+EImpulseRepNodeMapping UImpulseReplicationGraph::GetMappingPolicy(const AActor* Actor) const
+{
+	if (Actor->IsA<AGrappleHook>() || Actor->IsA<AGrappleHookCable>())
+		return bGrappleActorsOwnerOnly ? REPNODE_OwnerOnly : REPNODE_SpatializeDynamic;
+
+	// Checked first, owner only info actors must not reach the other connections
+	if (Actor->bOnlyRelevantToOwner)
+	{
+		// The connection nodes already add the player controller of their connection
+		if (Actor->IsA<APlayerController>())
+			return REPNODE_NotRouted;
+
+		return REPNODE_OwnerOnly;
+	}
+
+	if (Actor->bAlwaysRelevant || Actor->IsA<AInfo>())
+		return REPNODE_RelevantAllConnections;
+
+	// Characters go dormant while still, they can be treated as static until they wake up again
+	if (Actor->IsA<ACharacter>())
+		return REPNODE_SpatializeDormancy;
+
+	if (Actor->GetRootComponent() && !Actor->IsRootComponentMovable())
+		return REPNODE_SpatializeStatic;
+
+	return REPNODE_SpatializeDynamic;
+}
+
+UReplicationGraphNode_AlwaysRelevant_ForConnection* UImpulseReplicationGraph::GetOwnerOnlyNode(const AActor* Actor)
+{
+	UNetConnection* NetConnection = Actor->GetNetConnection();
+	if (!NetConnection)
+		return nullptr;
+
+	for (const TPair<UNetReplicationGraphConnection*, UReplicationGraphNode_AlwaysRelevant_ForConnection*>& Pair : OwnerOnlyNodes)
+	{
+		if (Pair.Key && Pair.Key->NetConnection == NetConnection)
+			return Pair.Value;
+	}
+
+	return nullptr;
+}
+
+void UImpulseReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	switch (GetMappingPolicy(ActorInfo.Actor))
+	{
+		case REPNODE_RelevantAllConnections:
+			{
+				AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+				break;
+			}
+		case REPNODE_SpatializeStatic:
+			{
+				GridNode->AddActor_Static(ActorInfo, GlobalInfo);
+				break;
+			}
+		case REPNODE_SpatializeDynamic:
+			{
+				GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+				break;
+			}
+		case REPNODE_SpatializeDormancy:
+			{
+				GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+				break;
+			}
+		case REPNODE_OwnerOnly:
+			{
+				if (UReplicationGraphNode_AlwaysRelevant_ForConnection* OwnerOnlyNode = GetOwnerOnlyNode(ActorInfo.Actor))
+					OwnerOnlyNode->NotifyAddNetworkActor(ActorInfo);
+				break;
+			}
+		default:
+			{
+				break;
+			}
+	}
+}
+
+void UImpulseReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+	switch (GetMappingPolicy(ActorInfo.Actor))
+	{
+		case REPNODE_RelevantAllConnections:
+			{
+				AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+				break;
+			}
+		case REPNODE_SpatializeStatic:
+			{
+				GridNode->RemoveActor_Static(ActorInfo);
+				break;
+			}
+		case REPNODE_SpatializeDynamic:
+			{
+				GridNode->RemoveActor_Dynamic(ActorInfo);
+				break;
+			}
+		case REPNODE_SpatializeDormancy:
+			{
+				GridNode->RemoveActor_Dormancy(ActorInfo);
+				break;
+			}
+		case REPNODE_OwnerOnly:
+			{
+				// The owner may already be gone, so remove it from every connection
+				for (const TPair<UNetReplicationGraphConnection*, UReplicationGraphNode_AlwaysRelevant_ForConnection*>& Pair : OwnerOnlyNodes)
+					Pair.Value->NotifyRemoveNetworkActor(ActorInfo, false);
+				break;
+			}
+		default:
+			{
+				break;
+			}
+	}
+}
+
+void UImpulseReplicationGraph::SetMovementBoost(AActor* Actor, const bool bBoosted)
+{
+	if (!Actor)
+		return;
+
+	const FClassReplicationInfo& ClassInfo = GlobalActorReplicationInfoMap.GetClassInfo(Actor->GetClass());
+	FGlobalActorReplicationInfo& GlobalInfo = GlobalActorReplicationInfoMap.Get(Actor);
+
+	GlobalInfo.Settings.ReplicationPeriodFrame = bBoosted ? 1 : ClassInfo.ReplicationPeriodFrame;
+	GlobalInfo.Settings.DistancePriorityScale = bBoosted ? ClassInfo.DistancePriorityScale * BoostedDistancePriorityScale : ClassInfo.DistancePriorityScale;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "ImpulseReplicationGraph.generated.h"
+
+class UReplicationGraphNode_GridSpatialization2D;
+class UReplicationGraphNode_ActorList;
+class UReplicationGraphNode_AlwaysRelevant_ForConnection;
+
+/**
+ *	Determines which node an actor is routed to when it is added to the replication graph.
+ *	REPNODE_NotRouted - not routed to any node, replicated through the connection nodes (e.g. player controllers).
+ *	REPNODE_RelevantAllConnections - always relevant to every connection.
+ *	REPNODE_SpatializeStatic - spatialized once, never moves.
+ *	REPNODE_SpatializeDynamic - spatialized every frame.
+ *	REPNODE_SpatializeDormancy - spatialized every frame while awake, static while dormant.
+ *	REPNODE_OwnerOnly - only replicated to the connection that owns the actor.
+ */
+enum EImpulseRepNodeMapping : uint8
+{
+	REPNODE_NotRouted,
+	REPNODE_RelevantAllConnections,
+	REPNODE_SpatializeStatic,
+	REPNODE_SpatializeDynamic,
+	REPNODE_SpatializeDormancy,
+	REPNODE_OwnerOnly,
+};
+
+/**
+ *	Replication graph for Impulse. Characters are spatialized in a 2D grid so each connection only considers
+ *	the characters around its viewer, which makes the server cost scale with local density instead of player count.
+ *	Characters in a high velocity movement state are boosted by UMyCharacterMovementComponent and grapple actors are
+ *	only routed to the connection of their owner.
+ *
+ *	Enable it in DefaultEngine.ini:
+ *	[/Script/OnlineSubsystemUtils.IpNetDriver]
+ *	ReplicationDriverClassName="/Script/Impulse.ImpulseReplicationGraph"
+ */
+UCLASS(Transient, Config = Engine)
+class IMPULSE_API UImpulseReplicationGraph : public UReplicationGraph
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Constructor */
+	UImpulseReplicationGraph();
+
+	/** The size of a single cell of the spatialization grid. */
+	UPROPERTY(Config)
+	float GridCellSize = 10000.f;
+
+	/** The minimum x and y of the map, actors outside of this bound are clamped to the edge of the grid. */
+	UPROPERTY(Config)
+	float SpatialBiasX = -150000.f;
+
+	UPROPERTY(Config)
+	float SpatialBiasY = -200000.f;
+
+	/** Multiplier applied to the distance priority of boosted characters, lower means viewers near them are served first. */
+	UPROPERTY(Config)
+	float BoostedDistancePriorityScale = 0.25f;
+
+	/** If false the grapple actors are also spatialized for every other connection. */
+	UPROPERTY(Config)
+	bool bGrappleActorsOwnerOnly = true;
+
+	/**
+	 *	Boosts or resets the replication of a character, used while the character is in a high velocity movement state.
+	 *	A boosted character is considered every frame and prioritized for the connections near it.
+	 *	@param Actor the character being boosted.
+	 *	@param bBoosted true to boost the character, false to return to the class settings.
+	 */
+	void SetMovementBoost(AActor* Actor, bool bBoosted);
+
+protected:
+
+	virtual void InitGlobalActorClassSettings() override;
+
+	virtual void InitGlobalGraphNodes() override;
+
+	virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+
+	virtual void RemoveClientConnection(UNetConnection* NetConnection) override;
+
+	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+
+	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+
+private:
+
+	/**
+	 *	Determines which node an actor should be routed to.
+	 *	@param Actor the actor being routed.
+	 *	@return the mapping of the actor.
+	 */
+	EImpulseRepNodeMapping GetMappingPolicy(const AActor* Actor) const;
+
+	/**
+	 *	Finds the owner only node of the connection that owns the actor.
+	 *	@param Actor the actor being routed.
+	 *	@return the owner only node, or nullptr if the actor is not owned by a connection.
+	 */
+	UReplicationGraphNode_AlwaysRelevant_ForConnection* GetOwnerOnlyNode(const AActor* Actor);
+
+	/**
+	 *	Converts a net update frequency to the number of server frames between replications.
+	 *	@param NetUpdateFrequency the net update frequency.
+	 *	@return the replication period in frames, at least 1.
+	 */
+	uint32 GetReplicationPeriodFrameForFrequency(float NetUpdateFrequency) const;
+
+	/** The grid every spatialized actor is added to. */
+	UPROPERTY()
+	UReplicationGraphNode_GridSpatialization2D* GridNode;
+
+	/** Actors that are always relevant to every connection. */
+	UPROPERTY()
+	UReplicationGraphNode_ActorList* AlwaysRelevantNode;
+
+	/** The owner only node of every connection. */
+	UPROPERTY()
+	TMap<UNetReplicationGraphConnection*, UReplicationGraphNode_AlwaysRelevant_ForConnection*> OwnerOnlyNodes;
+};
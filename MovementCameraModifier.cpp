@@ -0,0 +1,34 @@
+#include "Character/Camera/MovementCameraModifier.h"
+
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/Pawn.h"
+#include "Character/Components/MyCharacterMovementComponent.h"
+
+UMovementCameraModifier::UMovementCameraModifier()
+{
+	// Apply after any other modifiers so the tilt is always relative to the final view
+	Priority = 255;
+}
+
+void UMovementCameraModifier::ModifyCamera(float DeltaTime, FVector ViewLocation, FRotator ViewRotation, float FOV,
+	FVector& NewViewLocation, FRotator& NewViewRotation, float& NewFOV)
+{
+	Super::ModifyCamera(DeltaTime, ViewLocation, ViewRotation, FOV, NewViewLocation, NewViewRotation, NewFOV);
+
+	const UMyCharacterMovementComponent* MovementComponent = GetViewTargetMovement();
+	const float TargetRoll = MovementComponent ? MovementComponent->GetCameraRoll() : 0.f;
+
+	CurrentRoll = FMath::FInterpTo(CurrentRoll, TargetRoll, DeltaTime, RollInterpSpeed);
+	NewViewRotation.Roll += CurrentRoll * Alpha;
+
+	if (MovementComponent)
+		NewViewLocation += MovementComponent->GetFixedTickRenderOffset() * Alpha;
+}
+
+UMyCharacterMovementComponent* UMovementCameraModifier::GetViewTargetMovement() const
+{
+	if (const APawn* Pawn = Cast<APawn>(GetViewTarget()))
+		return Cast<UMyCharacterMovementComponent>(Pawn->GetMovementComponent());
+
+	return nullptr;
+}
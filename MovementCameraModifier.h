@@ -0,0 +1,43 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Camera/CameraModifier.h"
+#include "MovementCameraModifier.generated.h"
+
+class UMyCharacterMovementComponent;
+
+/**
+ *	Local-only camera layer that tilts the view while sliding and wall running.
+ *	The roll is applied on top of the final view and never touches the control rotation,
+ *	so it is not sent to the server with ServerMove and does not prevent moves from combining.
+ */
+UCLASS()
+class IMPULSE_API UMovementCameraModifier : public UCameraModifier
+{
+	GENERATED_BODY()
+
+public:
+
+	/** Constructor */
+	UMovementCameraModifier();
+
+protected:
+
+	/** How fast the roll interpolates towards the target roll of the movement component. */
+	UPROPERTY(EditDefaultsOnly, Category = "Movement Camera")
+	float RollInterpSpeed = 10.f;
+
+	/** Applies the current movement roll to the view rotation. */
+	virtual void ModifyCamera(float DeltaTime, FVector ViewLocation, FRotator ViewRotation, float FOV, FVector& NewViewLocation, FRotator& NewViewRotation, float& NewFOV) override;
+
+private:
+
+	/**
+	 *	Finds the movement component of the current view target.
+	 *	@return the movement component, or nullptr if the view target does not use UMyCharacterMovementComponent.
+	 */
+	UMyCharacterMovementComponent* GetViewTargetMovement() const;
+
+	/** The roll currently applied to the view. */
+	float CurrentRoll = 0.f;
+};
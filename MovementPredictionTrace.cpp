@@ -0,0 +1,191 @@
+#include "Character/Components/MovementPredictionTrace.h"
+
+#if MOVEMENTPREDICTION_TRACE_ENABLED
+
+#include "Character/Components/MyCharacterMovementComponent.h"
+#include "GameFramework/Actor.h"
+#include "Engine/NetDriver.h"
+#include "Engine/PackageMapClient.h"
+#include "ProfilingDebugging/CountersTrace.h"
+#include "Trace/Trace.inl"
+
+UE_TRACE_CHANNEL_DEFINE(MovementPredictionChannel)
+
+UE_TRACE_EVENT_BEGIN(MovementPrediction, InputPressed)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, ActorId)
+	UE_TRACE_EVENT_FIELD(uint8, Input)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(MovementPrediction, MoveSent)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, ActorId)
+	UE_TRACE_EVENT_FIELD(float, MoveTimeStamp)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(MovementPrediction, ServerMove)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, ActorId)
+	UE_TRACE_EVENT_FIELD(float, MoveTimeStamp)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(MovementPrediction, InputAcked)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, ActorId)
+	UE_TRACE_EVENT_FIELD(uint8, Input)
+	UE_TRACE_EVENT_FIELD(float, MoveTimeStamp)
+	UE_TRACE_EVENT_FIELD(float, InputToSentMs)
+	UE_TRACE_EVENT_FIELD(float, InputToAckMs)
+	UE_TRACE_EVENT_FIELD(bool, Corrected)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(MovementPrediction, Correction)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, ActorId)
+	UE_TRACE_EVENT_FIELD(float, MoveTimeStamp)
+	UE_TRACE_EVENT_FIELD(int32, ReplayDepth)
+UE_TRACE_EVENT_END()
+
+TRACE_DECLARE_FLOAT_COUNTER(MovementPrediction_InputToServerMs, TEXT("MovementPrediction/InputToServerMs"));
+TRACE_DECLARE_FLOAT_COUNTER(MovementPrediction_InputToAckMs, TEXT("MovementPrediction/InputToAckMs"));
+TRACE_DECLARE_INT_COUNTER(MovementPrediction_ReplayDepth, TEXT("MovementPrediction/ReplayDepth"));
+
+namespace MovementPredictionTrace
+{
+	/**
+	 *	Returns an id that identifies the owning actor of the component on the client and the server alike.
+	 *	It is derived from the network GUID of the actor, zero if the actor has not been assigned one.
+	 */
+	uint32 GetActorId(const UMyCharacterMovementComponent& Component)
+	{
+		const AActor* Owner = Component.GetOwner();
+		const UNetDriver* NetDriver = Owner ? Owner->GetNetDriver() : nullptr;
+		if (!NetDriver || !NetDriver->GuidCache.IsValid())
+			return 0;
+
+		const FNetworkGUID NetGUID = NetDriver->GuidCache->GetNetGUID(Owner);
+		return NetGUID.IsValid() ? GetTypeHash(NetGUID) : 0;
+	}
+}
+
+void FMovementPredictionTrace::ResolvePendingInputs(UMyCharacterMovementComponent& Component, const float MoveTimeStamp, const bool bCorrected)
+{
+	TArray<FMovementPredictionPendingInput, TInlineAllocator<8>>& PendingInputs = Component.PredictionTraceState.PendingInputs;
+	if (PendingInputs.Num() == 0)
+		return;
+
+	const uint64 NowCycles = FPlatformTime::Cycles64();
+	const uint32 ActorId = MovementPredictionTrace::GetActorId(Component);
+
+	for (int32 Index = PendingInputs.Num() - 1; Index >= 0; --Index)
+	{
+		const FMovementPredictionPendingInput& Pending = PendingInputs[Index];
+		if (Pending.MoveTimeStamp < 0.f || Pending.MoveTimeStamp > MoveTimeStamp)
+			continue;
+
+		const float InputToSentMs = static_cast<float>(FPlatformTime::ToMilliseconds64(Pending.SentCycles - Pending.InputCycles));
+		const float InputToAckMs = static_cast<float>(FPlatformTime::ToMilliseconds64(NowCycles - Pending.InputCycles));
+
+		UE_TRACE_LOG(MovementPrediction, InputAcked, MovementPredictionChannel)
+			<< InputAcked.Cycle(NowCycles)
+			<< InputAcked.ActorId(ActorId)
+			<< InputAcked.Input(static_cast<uint8>(Pending.Input))
+			<< InputAcked.MoveTimeStamp(Pending.MoveTimeStamp)
+			<< InputAcked.InputToSentMs(InputToSentMs)
+			<< InputAcked.InputToAckMs(InputToAckMs)
+			<< InputAcked.Corrected(bCorrected);
+
+		TRACE_COUNTER_SET(MovementPrediction_InputToAckMs, InputToAckMs);
+
+		PendingInputs.RemoveAtSwap(Index, 1, false);
+	}
+}
+
+void FMovementPredictionTrace::OutputInput(UMyCharacterMovementComponent& Component, const EMovementPredictionInput Input)
+{
+	if (!UE_TRACE_CHANNELEXPR_IS_ENABLED(MovementPredictionChannel))
+		return;
+
+	const uint64 NowCycles = FPlatformTime::Cycles64();
+
+	UE_TRACE_LOG(MovementPrediction, InputPressed, MovementPredictionChannel)
+		<< InputPressed.Cycle(NowCycles)
+		<< InputPressed.ActorId(MovementPredictionTrace::GetActorId(Component))
+		<< InputPressed.Input(static_cast<uint8>(Input));
+
+	// Only autonomous proxies send moves, everyone else would never resolve the pending input
+	if (Component.GetOwner() && Component.GetOwner()->GetLocalRole() == ROLE_AutonomousProxy)
+	{
+		FMovementPredictionPendingInput& Pending = Component.PredictionTraceState.PendingInputs.AddDefaulted_GetRef();
+		Pending.InputCycles = NowCycles;
+		Pending.Input = Input;
+	}
+}
+
+void FMovementPredictionTrace::OutputMoveSent(UMyCharacterMovementComponent& Component, const FSavedMove_Character& Move)
+{
+	if (!UE_TRACE_CHANNELEXPR_IS_ENABLED(MovementPredictionChannel))
+		return;
+
+	const uint64 NowCycles = FPlatformTime::Cycles64();
+
+	UE_TRACE_LOG(MovementPrediction, MoveSent, MovementPredictionChannel)
+		<< MoveSent.Cycle(NowCycles)
+		<< MoveSent.ActorId(MovementPredictionTrace::GetActorId(Component))
+		<< MoveSent.MoveTimeStamp(Move.TimeStamp);
+
+	for (FMovementPredictionPendingInput& Pending : Component.PredictionTraceState.PendingInputs)
+	{
+		if (Pending.MoveTimeStamp < 0.f)
+		{
+			Pending.MoveTimeStamp = Move.TimeStamp;
+			Pending.SentCycles = NowCycles;
+			TRACE_COUNTER_SET(MovementPrediction_InputToServerMs, FPlatformTime::ToMilliseconds64(NowCycles - Pending.InputCycles));
+		}
+	}
+}
+
+void FMovementPredictionTrace::OutputServerMove(const UMyCharacterMovementComponent& Component, const float MoveTimeStamp)
+{
+	if (!UE_TRACE_CHANNELEXPR_IS_ENABLED(MovementPredictionChannel))
+		return;
+
+	UE_TRACE_LOG(MovementPrediction, ServerMove, MovementPredictionChannel)
+		<< ServerMove.Cycle(FPlatformTime::Cycles64())
+		<< ServerMove.ActorId(MovementPredictionTrace::GetActorId(Component))
+		<< ServerMove.MoveTimeStamp(MoveTimeStamp);
+}
+
+void FMovementPredictionTrace::OutputMoveAcked(UMyCharacterMovementComponent& Component, const float MoveTimeStamp)
+{
+	if (!UE_TRACE_CHANNELEXPR_IS_ENABLED(MovementPredictionChannel))
+		return;
+
+	ResolvePendingInputs(Component, MoveTimeStamp, false);
+}
+
+void FMovementPredictionTrace::OutputCorrection(UMyCharacterMovementComponent& Component, const float MoveTimeStamp, const int32 ReplayDepth)
+{
+	if (!UE_TRACE_CHANNELEXPR_IS_ENABLED(MovementPredictionChannel))
+		return;
+
+	UE_TRACE_LOG(MovementPrediction, Correction, MovementPredictionChannel)
+		<< Correction.Cycle(FPlatformTime::Cycles64())
+		<< Correction.ActorId(MovementPredictionTrace::GetActorId(Component))
+		<< Correction.MoveTimeStamp(MoveTimeStamp)
+		<< Correction.ReplayDepth(ReplayDepth);
+
+	TRACE_COUNTER_SET(MovementPrediction_ReplayDepth, ReplayDepth);
+
+	ResolvePendingInputs(Component, MoveTimeStamp, true);
+}
+
+#else
+
+void FMovementPredictionTrace::OutputInput(UMyCharacterMovementComponent& Component, EMovementPredictionInput Input) {}
+void FMovementPredictionTrace::OutputMoveSent(UMyCharacterMovementComponent& Component, const FSavedMove_Character& Move) {}
+void FMovementPredictionTrace::OutputServerMove(const UMyCharacterMovementComponent& Component, float MoveTimeStamp) {}
+void FMovementPredictionTrace::OutputMoveAcked(UMyCharacterMovementComponent& Component, float MoveTimeStamp) {}
+void FMovementPredictionTrace::OutputCorrection(UMyCharacterMovementComponent& Component, float MoveTimeStamp, int32 ReplayDepth) {}
+
+#endif
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Trace/Config.h"
+
+class UMyCharacterMovementComponent;
+class FSavedMove_Character;
+
+/** True when the movement prediction timeline should be written to Unreal Insights. */
+#if !defined(MOVEMENTPREDICTION_TRACE_ENABLED)
+#if UE_TRACE_ENABLED && !UE_BUILD_SHIPPING
+#define MOVEMENTPREDICTION_TRACE_ENABLED 1
+#else
+#define MOVEMENTPREDICTION_TRACE_ENABLED 0
+#endif
+#endif
+
+/**
+ *	The local inputs that are tracked on the movement prediction timeline.
+ *	Each input is followed from the moment it is pressed until the server acknowledges or corrects the move carrying it.
+ */
+enum class EMovementPredictionInput : uint8
+{
+	Jump,
+	Sprint,
+	Crouch,
+	Slide,
+	SlideJump,
+	Dodge,
+	Stimmy,
+	Grapple,
+};
+
+/** An input that has been pressed locally but not yet acknowledged by the server. */
+struct FMovementPredictionPendingInput
+{
+	/** The time the input was pressed, in platform cycles. */
+	uint64 InputCycles = 0;
+
+	/** The time the move carrying this input was sent, in platform cycles. Zero until the move is sent. */
+	uint64 SentCycles = 0;
+
+	/** The client time stamp of the saved move carrying this input. Negative until the move is sent. */
+	float MoveTimeStamp = -1.f;
+
+	/** The input that was pressed. */
+	EMovementPredictionInput Input = EMovementPredictionInput::Jump;
+};
+
+/** Per autonomous proxy bookkeeping used to measure input-to-ack latency. */
+struct FMovementPredictionTraceState
+{
+	/** Inputs waiting for their move to be sent or acknowledged. */
+	TArray<FMovementPredictionPendingInput, TInlineAllocator<8>> PendingInputs;
+};
+
+/**
+ *	Writes the movement prediction timeline to the MovementPrediction trace channel.
+ *	Enable it with -trace=default,MovementPrediction. The events can be joined on ActorId and MoveTimeStamp across the client and server traces,
+ *	and the InputToServerMs, InputToAckMs and ReplayDepth counters show up in the Insights counters view.
+ */
+struct IMPULSE_API FMovementPredictionTrace
+{
+	/** Records an input being pressed on the locally controlled character. */
+	static void OutputInput(UMyCharacterMovementComponent& Component, EMovementPredictionInput Input);
+
+	/** Records a saved move being sent to the server and stamps it onto any inputs still waiting to be sent. */
+	static void OutputMoveSent(UMyCharacterMovementComponent& Component, const FSavedMove_Character& Move);
+
+	/** Records the server processing a move from the client. */
+	static void OutputServerMove(const UMyCharacterMovementComponent& Component, float MoveTimeStamp);
+
+	/** Records the server acknowledging every move up to and including MoveTimeStamp. */
+	static void OutputMoveAcked(UMyCharacterMovementComponent& Component, float MoveTimeStamp);
+
+	/** Records a correction from the server and the number of moves that will be replayed because of it. */
+	static void OutputCorrection(UMyCharacterMovementComponent& Component, float MoveTimeStamp, int32 ReplayDepth);
+
+private:
+
+	/** Resolves every pending input that was sent in a move up to and including MoveTimeStamp. */
+	static void ResolvePendingInputs(UMyCharacterMovementComponent& Component, float MoveTimeStamp, bool bCorrected);
+};
+
+// The call sites supply the semicolon, so every form is a single statement even without braces
+#if MOVEMENTPREDICTION_TRACE_ENABLED
+
+#define TRACE_MOVEMENT_INPUT(Component, Input) \
+	FMovementPredictionTrace::OutputInput(Component, Input)
+
+#define TRACE_MOVEMENT_MOVE_SENT(Component, Move) \
+	FMovementPredictionTrace::OutputMoveSent(Component, Move)
+
+#define TRACE_MOVEMENT_SERVER_MOVE(Component, MoveTimeStamp) \
+	FMovementPredictionTrace::OutputServerMove(Component, MoveTimeStamp)
+
+#define TRACE_MOVEMENT_MOVE_ACKED(Component, MoveTimeStamp) \
+	FMovementPredictionTrace::OutputMoveAcked(Component, MoveTimeStamp)
+
+#define TRACE_MOVEMENT_CORRECTION(Component, MoveTimeStamp, ReplayDepth) \
+	FMovementPredictionTrace::OutputCorrection(Component, MoveTimeStamp, ReplayDepth)
+
+#else
+
+#define TRACE_MOVEMENT_INPUT(Component, Input) ((void)0)
+#define TRACE_MOVEMENT_MOVE_SENT(Component, Move) ((void)0)
+#define TRACE_MOVEMENT_SERVER_MOVE(Component, MoveTimeStamp) ((void)0)
+#define TRACE_MOVEMENT_MOVE_ACKED(Component, MoveTimeStamp) ((void)0)
+#define TRACE_MOVEMENT_CORRECTION(Component, MoveTimeStamp, ReplayDepth) ((void)0)
+
+#endif
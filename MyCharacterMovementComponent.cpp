@@ -7,10 +7,52 @@
 #include "Character/ImpulseDefaultCharacter.h"
 #include "Character/Abilities/Movement/GrappleHook.h"
 #include "Character/Abilities/Movement/GrappleHookCable.h"
+#include "Character/Camera/MovementCameraModifier.h"
+#include "Replication/ImpulseReplicationGraph.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/GameNetworkManager.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "Engine/NetDriver.h"
 #include "Net/UnrealNetwork.h"
 #include "Engine/World.h"
 #include "Kismet/KismetMathLibrary.h"
 
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Server Moves Sent"), STAT_MyMovement_ServerMovesSent, STATGROUP_MyCharacterMovement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Saved Moves Combined"), STAT_MyMovement_SavedMovesCombined, STATGROUP_MyCharacterMovement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Saved Move Pool Peak In Use"), STAT_MyMovement_SavedMovePoolPeakInUse, STATGROUP_MyCharacterMovement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Saved Move Pool Exhausted"), STAT_MyMovement_SavedMovePoolExhausted, STATGROUP_MyCharacterMovement);
+DECLARE_MEMORY_STAT(TEXT("Saved Move Pool Memory"), STAT_MyMovement_SavedMovePoolMemory, STATGROUP_MyCharacterMovement);
+DECLARE_MEMORY_STAT(TEXT("Saved Move Pool Memory Per Client"), STAT_MyMovement_SavedMovePoolMemoryPerClient, STATGROUP_MyCharacterMovement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Important Moves Resent"), STAT_MyMovement_ImportantMovesResent, STATGROUP_MyCharacterMovement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Old Moves Recovered"), STAT_MyMovement_OldMovesRecovered, STATGROUP_MyCharacterMovement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Corrections Received"), STAT_MyMovement_CorrectionsReceived, STATGROUP_MyCharacterMovement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Client Moves Accepted"), STAT_MyMovement_ClientMovesAccepted, STATGROUP_MyCharacterMovement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Client Moves Outside Envelope"), STAT_MyMovement_ClientMovesOutsideEnvelope, STATGROUP_MyCharacterMovement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Correction Replay Depth"), STAT_MyMovement_CorrectionReplayDepth, STATGROUP_MyCharacterMovement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Replay Moves Collapsed"), STAT_MyMovement_ReplayMovesCollapsed, STATGROUP_MyCharacterMovement);
+DECLARE_CYCLE_STAT(TEXT("Correction Replay"), STAT_MyMovement_CorrectionReplay, STATGROUP_MyCharacterMovement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Moves Sent Immediately"), STAT_MyMovement_MovesSentImmediately, STATGROUP_MyCharacterMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Server Move Buffer Depth"), STAT_MyMovement_ServerMoveBufferDepth, STATGROUP_MyCharacterMovement);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Server Move Buffer Delay (ms)"), STAT_MyMovement_ServerMoveBufferDelay, STATGROUP_MyCharacterMovement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Speed State Cache Hits"), STAT_MyMovement_SpeedStateCacheHits, STATGROUP_MyCharacterMovement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Speed State Cache Misses"), STAT_MyMovement_SpeedStateCacheMisses, STATGROUP_MyCharacterMovement);
+DECLARE_CYCLE_STAT(TEXT("Calc Velocity"), STAT_MyMovement_CalcVelocity, STATGROUP_MyCharacterMovement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("State RPCs Sent"), STAT_MyMovement_StateRPCsSent, STATGROUP_MyCharacterMovement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("State RPCs Suppressed"), STAT_MyMovement_StateRPCsSuppressed, STATGROUP_MyCharacterMovement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Cosmetic Event Batches Sent"), STAT_MyMovement_CosmeticEventBatchesSent, STATGROUP_MyCharacterMovement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Cosmetic Event Batches Dropped"), STAT_MyMovement_CosmeticEventBatchesDropped, STATGROUP_MyCharacterMovement);
+DECLARE_CYCLE_STAT(TEXT("Update Net Update Frequency"), STAT_MyMovement_UpdateNetUpdateFrequency, STATGROUP_MyCharacterMovement);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Net Update Frequency"), STAT_MyMovement_NetUpdateFrequency, STATGROUP_MyCharacterMovement);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Net Updates Saved Per Second"), STAT_MyMovement_NetUpdatesSaved, STATGROUP_MyCharacterMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dormant Characters"), STAT_MyMovement_DormantCharacters, STATGROUP_MyCharacterMovement);
+DECLARE_CYCLE_STAT(TEXT("Simulated Proxy Tick"), STAT_MyMovement_SimulatedProxyTick, STATGROUP_MyCharacterMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Simulated Proxies Ticked"), STAT_MyMovement_SimulatedProxiesTicked, STATGROUP_MyCharacterMovement);
+DECLARE_CYCLE_STAT(TEXT("Server Controlled AI Tick"), STAT_MyMovement_ServerControlledAITick, STATGROUP_MyCharacterMovement);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Server Controlled AI Ticked"), STAT_MyMovement_ServerControlledAITicked, STATGROUP_MyCharacterMovement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Fixed Ticks"), STAT_MyMovement_FixedTicks, STATGROUP_MyCharacterMovement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Fixed Ticks Dropped"), STAT_MyMovement_FixedTicksDropped, STATGROUP_MyCharacterMovement);
+
 #pragma region class MyCharacterMovementComponent
 
 UMyCharacterMovementComponent::UMyCharacterMovementComponent()
@@ -18,28 +60,83 @@ UMyCharacterMovementComponent::UMyCharacterMovementComponent()
 	NavAgentProps.bCanCrouch = true;
 	NavAgentProps.bCanSwim = false;
 	bCanWalkOffLedgesWhenCrouching = true;
+	bWantsInitializeComponent = true;
+
+	MovementTuning = nullptr;
+	Tuning = GetDefault<UMyMovementTuning>();
+	ApplyTuning();
 	
-	MaxWalkSpeed = DefaultMaxRunSpeed;
-	MaxAcceleration = DefaultMaxRunAcceleration;
-	GroundFriction = DefaultGroundFriction;
-	BrakingDecelerationWalking = DefaultBrakingDecelerationWalking;
-	
-	GravityScale = DefaultGravityScale;
-	JumpZVelocity = DefaultJumpZVelocity;
-	AirControl = DefaultAirControl;
-	AirControlBoostMultiplier = DefaultAirControlBoostMultiplier;
-	AirControlBoostVelocityThreshold = DefaultAirControlBoostVelocityThreshold;
-	FallingLateralFriction = DefaultFallingLateralFriction;
-
-	CurrentMaxSprintSpeed = DefaultMaxSprintSpeed;
-	CurrentMaxSprintAcceleration = DefaultMaxSprintAcceleration;
-	MaxWalkSpeedCrouched = DefaultMaxWalkSpeedCrouched;
-
-	CurrentMaxRunSpeed = DefaultMaxRunSpeed;
-	CurrentMaxRunAcceleration = DefaultMaxRunAcceleration;
 	CurrentGrappleHookState = GRAPPLE_Ready;
+	CameraModifierClass = UMovementCameraModifier::StaticClass();
+}
+
+void UMyCharacterMovementComponent::ApplyTuning()
+{
+	MaxWalkSpeed = GetTuning().DefaultMaxRunSpeed;
+	MaxAcceleration = GetTuning().DefaultMaxRunAcceleration;
+	GroundFriction = GetTuning().DefaultGroundFriction;
+	BrakingDecelerationWalking = GetTuning().DefaultBrakingDecelerationWalking;
+	MaxStepHeight = GetTuning().DefaultMaxStepHeight;
+	SetWalkableFloorZ(GetTuning().DefaultWalkableFloorZ);
+	
+	GravityScale = GetTuning().DefaultGravityScale;
+	JumpZVelocity = GetTuning().DefaultJumpZVelocity;
+	AirControl = GetTuning().DefaultAirControl;
+	AirControlBoostMultiplier = GetTuning().DefaultAirControlBoostMultiplier;
+	AirControlBoostVelocityThreshold = GetTuning().DefaultAirControlBoostVelocityThreshold;
+	FallingLateralFriction = GetTuning().DefaultFallingLateralFriction;
+	
+	MaxWalkSpeedCrouched = GetTuning().DefaultMaxWalkSpeedCrouched;
+
+	// Any active modifiers have to be applied on top of the new defaults
+	bMovementModifiersDirty = true;
+}
+
+#pragma region Movement Modifier Functions
+
+void UMyCharacterMovementComponent::PushMovementModifier(const EMovementModifier Modifier)
+{
+	SetMovementModifiers(ActiveMovementModifiers | (1 << Modifier));
+}
+
+void UMyCharacterMovementComponent::PopMovementModifier(const EMovementModifier Modifier)
+{
+	SetMovementModifiers(ActiveMovementModifiers & ~(1 << Modifier));
 }
 
+void UMyCharacterMovementComponent::SetMovementModifiers(const uint8 NewModifiers)
+{
+	if (NewModifiers == ActiveMovementModifiers)
+		return;
+
+	ActiveMovementModifiers = NewModifiers;
+	bMovementModifiersDirty = true;
+	InvalidateSpeedState();
+}
+
+void UMyCharacterMovementComponent::ApplyMovementModifiers()
+{
+	if (!bMovementModifiersDirty)
+		return;
+
+	bMovementModifiersDirty = false;
+
+	// Modifiers are checked from the highest priority to the lowest, the first one that overrides a value wins
+	if (HasMovementModifier(MODIFIER_Grapple) || HasMovementModifier(MODIFIER_Dodge) || HasMovementModifier(MODIFIER_Slide))
+		GroundFriction = 0.f;
+	else
+		GroundFriction = GetTuning().DefaultGroundFriction;
+
+	if (HasMovementModifier(MODIFIER_Grapple))
+		GravityScale = 0.f;
+	else if (HasMovementModifier(MODIFIER_SlideJump))
+		GravityScale = GetTuning().SlideJumpGravityScale;
+	else
+		GravityScale = GetTuning().DefaultGravityScale;
+}
+
+#pragma endregion
+
 #pragma region Jumping Functions
 
 void UMyCharacterMovementComponent::SetJumping(bool bJumped)
@@ -51,46 +148,31 @@ void UMyCharacterMovementComponent::SetJumping(bool bJumped)
 
 		if (bJumped)
 		{
-			Jumped = true;
-			ServerSetJumping(true);
-			FTimerHandle FJumped;
-			GetWorld()->GetTimerManager().SetTimer(FJumped, this, &UMyCharacterMovementComponent::JumpedFalse, 0.1f, false);
+			TRACE_MOVEMENT_INPUT(*this, EMovementPredictionInput::Jump);
 		}
 	}
 }
 
-void UMyCharacterMovementComponent::ServerSetJumping_Implementation(bool bJumped)
-{
-	MultiSetJumping(bJumped);
-}
-
-bool UMyCharacterMovementComponent::ServerSetJumping_Validate(bool bJumped)
+bool UMyCharacterMovementComponent::DoJump(bool bReplayingMoves)
 {
-	return true;
-}
+	if (!Super::DoJump(bReplayingMoves))
+		return false;
 
-void UMyCharacterMovementComponent::MultiSetJumping_Implementation(bool bJumped)
-{
-	Jumped = bJumped;
-}
+	if (!bReplayingMoves)
+		AddCosmeticEvent(EVENT_Jump);
 
-bool UMyCharacterMovementComponent::MultiSetJumping_Validate(bool bJumped)
-{
 	return true;
 }
 
-void UMyCharacterMovementComponent::JumpedFalse()
-{
-	Jumped = false;
-	ServerSetJumping(false);
-}
-
 #pragma endregion
 
 #pragma region Sprinting Functions
 
 void UMyCharacterMovementComponent::SetSprinting(const bool Sprinting)
 {
+	if (Sprinting && !WantsToSprint)
+		TRACE_MOVEMENT_INPUT(*this, EMovementPredictionInput::Sprint);
+	
 	WantsToSprint = Sprinting;
 	//WallRunKeysDown = WantsToSprint;
 	
@@ -120,15 +202,16 @@ bool UMyCharacterMovementComponent::IsMovingForward() const
 
 #pragma region Crouching Functions
 
-void UMyCharacterMovementComponent::BeginCrouch_Implementation()
+void UMyCharacterMovementComponent::BeginCrouch()
 {
+	TRACE_MOVEMENT_INPUT(*this, EMovementPredictionInput::Crouch);
 	WantsToCrouch = true;
 	bWantsToCrouch = true; //built in crouch bool
 	SlideKeysDown = AreRequiredSlideKeysDown();
 	CheckSlide();	
 }
 
-void UMyCharacterMovementComponent::EndCrouch_Implementation()
+void UMyCharacterMovementComponent::EndCrouch()
 {
 	WantsToCrouch = false;
 	bWantsToCrouch = false; //built in crouch bool
@@ -144,19 +227,14 @@ void UMyCharacterMovementComponent::BeginSlide()
 {
 	if (SlideKeysDown && CanSlide && IsMovingForward())
 	{
-		GroundFriction = 0.f;
-
-		if (IsStimmy)
-			MaxWalkSpeedCrouched = MaxSlideSpeed * StimmySpeedMultiplier;
-		else
-			MaxWalkSpeedCrouched = MaxSlideSpeed;
+		TRACE_MOVEMENT_INPUT(*this, EMovementPredictionInput::Slide);
+		bWantsToSlide = true;
 		
 		CanSlide = true;
 		
-		if (PawnOwner->GetLocalRole() < ROLE_Authority)
-			ServerBeginSlide();
-		
-		GetWorld()->GetTimerManager().SetTimer(SlideTimerHandle, this, &UMyCharacterMovementComponent::DoSlide, 0.5f, true);
+		// The fixed tick simulation applies the slide forces from AdvanceFixedTickAbilities instead
+		if (!bUseFixedTickSimulation)
+			GetWorld()->GetTimerManager().SetTimer(SlideTimerHandle, this, &UMyCharacterMovementComponent::DoSlide, 0.5f, true);
 	}
 }
 
@@ -164,15 +242,7 @@ void UMyCharacterMovementComponent::EndSlide()
 {	
 	CanSlide = false;
 
-	GroundFriction = DefaultGroundFriction;
-	
-	if (IsStimmy)
-		MaxWalkSpeedCrouched = DefaultMaxWalkSpeedCrouched * StimmySpeedMultiplier;
-	else
-		MaxWalkSpeedCrouched = DefaultMaxWalkSpeedCrouched;
-	
-	if (PawnOwner->GetLocalRole() < ROLE_Authority)
-		ServerEndSlide();
+	bWantsToSlide = false;
 	
 	GetWorld()->GetTimerManager().ClearTimer(SlideTimerHandle);
 	FTimerHandle SlideCooldown;
@@ -207,17 +277,8 @@ void UMyCharacterMovementComponent::DoSlide()
 {
 	if (SlideKeysDown && CanSlide && IsMovingForward())
 	{
-		const FVector FloorNormal = CurrentFloor.HitResult.Normal;
-		
-		const FVector Force = CalcFloorInfluence(FloorNormal);
-		AddForce(Force);
-		
-		const FVector NormalSpeed = UKismetMathLibrary::Normal(GetLastUpdateVelocity());
-		
-		if (!(UKismetMathLibrary::Dot_VectorVector(FloorNormal, FVector(NormalSpeed.X, NormalSpeed.Y, 0.f)) > 0.1f))
-		{
+		if (!ApplySlideForce())
 			EndSlide();
-		}
 	}
 	else
 	{
@@ -225,6 +286,18 @@ void UMyCharacterMovementComponent::DoSlide()
 	}
 }
 
+bool UMyCharacterMovementComponent::ApplySlideForce()
+{
+	const FVector FloorNormal = CurrentFloor.HitResult.Normal;
+	
+	const FVector Force = CalcFloorInfluence(FloorNormal);
+	AddForce(Force);
+	
+	const FVector NormalSpeed = UKismetMathLibrary::Normal(GetLastUpdateVelocity());
+	
+	return UKismetMathLibrary::Dot_VectorVector(FloorNormal, FVector(NormalSpeed.X, NormalSpeed.Y, 0.f)) > 0.1f;
+}
+
 FVector UMyCharacterMovementComponent::CalcFloorInfluence(const FVector FloorNormal)
 {
 	const FVector VectorUp = FVector(0.f, 0.f, 1.f);
@@ -242,92 +315,46 @@ FVector UMyCharacterMovementComponent::CalcFloorInfluence(const FVector FloorNor
 	return (SlopeScale * FloorDirectionNormal);
 }
 
-void UMyCharacterMovementComponent::SlideCameraRotate() const
+float UMyCharacterMovementComponent::GetSlideCameraRoll() const
 {
-	if (GetPawnOwner()->IsLocallyControlled())
-	{
-		if (GetController())
-		{
-			const AActor* Actor = Cast<AActor>(GetOwner());
-			const FVector RightVector = Actor->GetActorRightVector();
-			const FVector VelocityNormal = UKismetMathLibrary::Normal(Velocity, 0.001f);
-			const float Dot = UKismetMathLibrary::Dot_VectorVector(RightVector, VelocityNormal);
-			
-			const FVector2d Velocity2D = UKismetMathLibrary::Conv_VectorToVector2D(Velocity);
-			const float ClampedRange = UKismetMathLibrary::MapRangeClamped(Velocity2D.Length(), 0.f, 1200.f, 0.f, 1.f);
-
-			const float XRotation = ClampedRange * -10.f * Dot;
-			const FRotator Target = FRotator(GetController()->GetControlRotation().Pitch, GetController()->GetControlRotation().Yaw, XRotation);
-			const FRotator NewRotation = UKismetMathLibrary::RInterpTo(GetController()->GetControlRotation(), Target, GetWorld()->DeltaTimeSeconds, 10.f);
-			
-			GetController()->SetControlRotation(NewRotation);
-		}
-	}
-}
-
-void UMyCharacterMovementComponent::ServerBeginSlide_Implementation()
-{
-	IsSliding = true;
-	GroundFriction = 0.f;
-
-	if (IsStimmy)
-		MaxWalkSpeedCrouched = MaxSlideSpeed * StimmySpeedMultiplier;
-	else
-		MaxWalkSpeedCrouched = MaxSlideSpeed;
+	const FVector RightVector = GetOwner()->GetActorRightVector();
+	const FVector VelocityNormal = UKismetMathLibrary::Normal(Velocity, 0.001f);
+	const float Dot = UKismetMathLibrary::Dot_VectorVector(RightVector, VelocityNormal);
 	
-	MultiSetIsSliding(IsSliding);
-}
+	const FVector2d Velocity2D = UKismetMathLibrary::Conv_VectorToVector2D(Velocity);
+	const float ClampedRange = UKismetMathLibrary::MapRangeClamped(Velocity2D.Length(), 0.f, 1200.f, 0.f, 1.f);
 
-bool UMyCharacterMovementComponent::ServerBeginSlide_Validate()
-{
-	return true;
+	return ClampedRange * -10.f * Dot;
 }
 
-void UMyCharacterMovementComponent::ServerEndSlide_Implementation()
+void UMyCharacterMovementComponent::UpdateSlideState()
 {
-	IsSliding = false;
-	GroundFriction = DefaultGroundFriction;
-	
-	if (IsStimmy)
-		MaxWalkSpeedCrouched = DefaultMaxWalkSpeedCrouched * StimmySpeedMultiplier;
+	if (bWantsToSlide)
+		PushMovementModifier(MODIFIER_Slide);
 	else
-		MaxWalkSpeedCrouched = DefaultMaxWalkSpeedCrouched;	
-	
-	MultiSetIsSliding(IsSliding);
-}
-
-bool UMyCharacterMovementComponent::ServerEndSlide_Validate()
-{
-	return true;
-}
+		PopMovementModifier(MODIFIER_Slide);
 
-void UMyCharacterMovementComponent::MultiSetIsSliding_Implementation(const bool Sliding)
-{
-	IsSliding = Sliding;
+	// Only the server decides if the character is sliding, the move stream guarantees it sees the request in order with the moves
+	if (GetOwner()->HasAuthority() && IsSliding != static_cast<bool>(bWantsToSlide))
+	{
+		IsSliding = bWantsToSlide;
+		PushDiscreteMovementState();
+	}
 }
 
-bool UMyCharacterMovementComponent::MultiSetIsSliding_Validate(const bool Sliding)
+void UMyCharacterMovementComponent::OnRep_IsSliding()
 {
-	return true;
+	PushDiscreteMovementState();
 }
 
 #pragma endregion
 
 #pragma region Wall Running Functions
 
-void UMyCharacterMovementComponent::ServerSetWallRunSide_Implementation(EWallRunSide WRSide)
-{
-	MultiSetWallRunSide(WRSide);
-}
-
-bool UMyCharacterMovementComponent::ServerSetWallRunSide_Validate(EWallRunSide WRSide)
-{
-	return true;
-}
-
 void UMyCharacterMovementComponent::MultiSetWallRunSide_Implementation(EWallRunSide WRSide)
 {
 	WallRunSide = WRSide;
+	PushDiscreteMovementState();
 }
 
 bool UMyCharacterMovementComponent::MultiSetWallRunSide_Validate(EWallRunSide WRSide)
@@ -349,46 +376,51 @@ bool UMyCharacterMovementComponent::BeginWallRun()
 	return false;
 }
 
-void UMyCharacterMovementComponent::WallRunCameraRotate(const float Roll) const
+float UMyCharacterMovementComponent::GetWallRunCameraRoll() const
 {
-	const float CameraPitch = GetController()->GetControlRotation().Pitch;
-	const float CameraYaw = GetController()->GetControlRotation().Yaw;
-	const FRotator NewRotation = FRotator(CameraPitch, CameraYaw, Roll);
+	if (!IsCustomMovementMode(CMOVE_WallRunning))
+		return 0.f;
+	
+	if (WallRunSide == kRight)
+		return 15.f;
+	
+	if (WallRunSide == kLeft)
+		return -15.f;
 
-	GetController()->SetControlRotation(FMath::RInterpTo(GetController()->GetControlRotation(), NewRotation, GetWorld()->DeltaTimeSeconds, 10.f));
+	return 0.f;
 }
 
-void UMyCharacterMovementComponent::CameraTick() const
+float UMyCharacterMovementComponent::GetCameraRoll() const
 {
-	if (IsSliding)
-		SlideCameraRotate();
+	if (IsCustomMovementMode(CMOVE_WallRunning))
+		return GetWallRunCameraRoll();
 	
-	if (!IsCustomMovementMode(CMOVE_WallRunning))
-	{
-		WallRunCameraRotate(0.f);
-		return;
-	}
+	if (HasMovementModifier(MODIFIER_Slide))
+		return GetSlideCameraRoll();
 	
-	if (WallRunSide == kRight)
-	{
-		WallRunCameraRotate(15.f);
-	}
-	else if (WallRunSide == kLeft)
-	{
-		WallRunCameraRotate(-15.f);
-	}
+	return 0.f;
+}
+
+void UMyCharacterMovementComponent::AddCameraModifier()
+{
+	const APlayerController* PlayerController = Cast<APlayerController>(GetController());
+	if (!PlayerController || !PlayerController->PlayerCameraManager || !CameraModifierClass)
+		return;
+
+	CameraModifier = PlayerController->PlayerCameraManager->FindCameraModifierByClass(CameraModifierClass);
+	if (!CameraModifier.IsValid())
+		CameraModifier = PlayerController->PlayerCameraManager->AddNewCameraModifier(CameraModifierClass);
 }
 
 void UMyCharacterMovementComponent::WallRunJump()
 {
 	EndWallRun();
 	AImpulseDefaultCharacter* Player = Cast<AImpulseDefaultCharacter>(GetOwner());
-	Player->LaunchCharacter(FVector(WallRunNormal.X * HorizontalWallJumpOffForce, WallRunNormal.Y * HorizontalWallJumpOffForce, VerticalWallJumpOffForce), false, true);
+	Player->LaunchCharacter(FVector(WallRunNormal.X * GetTuning().HorizontalWallJumpOffForce, WallRunNormal.Y * GetTuning().HorizontalWallJumpOffForce, GetTuning().VerticalWallJumpOffForce), false, true);
 
-	Jumped = true;
-	ServerSetJumping(true);
-	FTimerHandle FJumped;
-	GetWorld()->GetTimerManager().SetTimer(FJumped, this, &UMyCharacterMovementComponent::JumpedFalse, 0.1f, false);
+	// Correction replays run PhysWallRunning again, the wall jump was already recorded the first time
+	if (!CharacterOwner->bClientUpdating)
+		AddCosmeticEvent(EVENT_WallJump);
 }
 
 void UMyCharacterMovementComponent::EndWallRun()
@@ -396,7 +428,7 @@ void UMyCharacterMovementComponent::EndWallRun()
 	// Set the movement mode back to falling
 	SetMovementMode(MOVE_Falling);
 	WallRunSide = kStraight;
-	ServerSetWallRunSide(kStraight);
+	RequestServerStateSync();
 }
 
 bool UMyCharacterMovementComponent::AreRequiredWallRunKeysDown() const
@@ -414,15 +446,28 @@ bool UMyCharacterMovementComponent::AreRequiredWallRunKeysDown() const
 bool UMyCharacterMovementComponent::IsNextToWall(float VerticalTolerance) const
 {
 	// Do a line trace from the player into the wall to make sure we're still along the side of a wall
-	FVector CrossVector = WallRunSide == kLeft ? FVector(0.0f, 0.0f, -1.0f) : FVector(0.0f, 0.0f, 1.0f);
-	FVector TraceStart = GetPawnOwner()->GetActorLocation() + (WallRunDirection * 20.0f);
-	FVector TraceEnd = TraceStart + (FVector::CrossProduct(WallRunDirection, CrossVector) * 100);
+	FVector TraceStart;
+	FVector TraceEnd;
+	GetNextToWallTrace(TraceStart, TraceEnd);
+
+	return TraceNextToWall(GetWorld(), TraceStart, TraceEnd, VerticalTolerance);
+}
+
+void UMyCharacterMovementComponent::GetNextToWallTrace(FVector& OutStart, FVector& OutEnd) const
+{
+	const FVector CrossVector = WallRunSide == kLeft ? FVector(0.0f, 0.0f, -1.0f) : FVector(0.0f, 0.0f, 1.0f);
+	OutStart = GetPawnOwner()->GetActorLocation() + (WallRunDirection * 20.0f);
+	OutEnd = OutStart + (FVector::CrossProduct(WallRunDirection, CrossVector) * GetTuning().WallRunTraceReach);
+}
+
+bool UMyCharacterMovementComponent::TraceNextToWall(const UWorld* World, const FVector& TraceStart, const FVector& TraceEnd, float VerticalTolerance)
+{
 	FHitResult HitResult;
 
 	// Create a helper lambda for performing the line trace
 	auto LineTrace = [&](const FVector& Start, const FVector& End)
 	{
-		return (GetWorld()->LineTraceSingleByChannel(HitResult, Start, End, ECollisionChannel::ECC_Visibility));
+		return (World->LineTraceSingleByChannel(HitResult, Start, End, ECollisionChannel::ECC_Visibility));
 	};
 
 	// If a vertical tolerance was provided we want to do two line traces - one above and one below the calculated line
@@ -450,6 +495,7 @@ bool UMyCharacterMovementComponent::IsNextToWall(float VerticalTolerance) const
 	//{
 		//return false;
 	//}
+	
 	return true;
 }
 
@@ -462,13 +508,11 @@ void UMyCharacterMovementComponent::FindWallRunDirectionAndSide(const FVector& S
 	if (FVector2D::DotProduct(FVector2D(SurfaceNormal), FVector2D(GetPawnOwner()->GetActorRightVector())) > 0.0)
 	{
 		Side = kRight;
-		ServerSetWallRunSide(Side);
 		CrossVector = FVector(0.0f, 0.0f, 1.0f);
 	}
 	else
 	{
 		Side = kLeft;
-		ServerSetWallRunSide(Side);
 		CrossVector = FVector(0.0f, 0.0f, -1.0f);
 	}
 
@@ -510,13 +554,20 @@ void UMyCharacterMovementComponent::OnActorHit(AActor* SelfActor, AActor* OtherA
 	if (CanSurfaceBeWallRan(Hit.ImpactNormal) == false)
 		return;
 
-	// Update the wall run direction and side
+	// Update the wall run direction and side, IsNextToWall() traces along them
+	const FVector PreviousWallRunDirection = WallRunDirection;
+	const EWallRunSide PreviousWallRunSide = WallRunSide;
 	FindWallRunDirectionAndSide(Hit.ImpactNormal, WallRunDirection, WallRunSide);
 
-	// Make sure we're next to a wall
+	// Make sure we're next to a wall, otherwise put back the old values so the rejected wall is never sent to the server
 	if (IsNextToWall() == false)
+	{
+		WallRunDirection = PreviousWallRunDirection;
+		WallRunSide = PreviousWallRunSide;
 		return;
+	}
 	
+	RequestServerStateSync();
 
 	WallRunNormal = Hit.ImpactNormal;
 	BeginWallRun();
@@ -534,24 +585,17 @@ void UMyCharacterMovementComponent::PhysWallRunning(float DeltaTime, int32 Itera
 	// Make sure we're still next to a wall. Provide a vertical tolerance for the line trace since it's possible the the server has
 	// moved our character slightly since we've began the wall run. In the event we're right at the top/bottom of a wall we need this
 	// tolerance value so we don't immediately fall of the wall 
-	if (IsNextToWall(LineTraceVerticalTolerance) == false)
+	if (IsNextToWall(GetTuning().LineTraceVerticalTolerance) == false)
 	{
 		EndWallRun();
 		return;
 	}
 
 	// Set the owning player's new velocity based on the wall run direction
+	const float WallRunSpeed = GetTuning().GetMaxSpeed(SPEED_WallRun, IsStimmy);
 	FVector newVelocity = WallRunDirection;
-	if (IsStimmy)
-	{
-		newVelocity.X *= (WallRunSpeed * StimmySpeedMultiplier);
-		newVelocity.Y *= (WallRunSpeed * StimmySpeedMultiplier);
-	}
-	else
-	{
-		newVelocity.X *= WallRunSpeed;
-		newVelocity.Y *= WallRunSpeed;
-	}
+	newVelocity.X *= WallRunSpeed;
+	newVelocity.Y *= WallRunSpeed;
 	newVelocity.Z *= 0.0f;
 	Velocity = newVelocity;
 
@@ -567,16 +611,19 @@ void UMyCharacterMovementComponent::PhysWallRunning(float DeltaTime, int32 Itera
 void UMyCharacterMovementComponent::DoDodge()
 {
 	if (CanDodge)
+	{
+		TRACE_MOVEMENT_INPUT(*this, EMovementPredictionInput::Dodge);
 		bWantsToDodge = true;
+	}
 }
 
 void UMyCharacterMovementComponent::EndDodge()
 {
 	StopMovementImmediately();
-	GroundFriction = DefaultGroundFriction;
+	PopMovementModifier(MODIFIER_Dodge);
 	
 	FTimerHandle DodgeCooldown;
-	GetWorld()->GetTimerManager().SetTimer(DodgeCooldown, this, &UMyCharacterMovementComponent::AllowDodge, BlinkCooldown, false);
+	GetWorld()->GetTimerManager().SetTimer(DodgeCooldown, this, &UMyCharacterMovementComponent::AllowDodge, GetTuning().BlinkCooldown, false);
 }
 
 void UMyCharacterMovementComponent::AllowDodge()
@@ -592,42 +639,21 @@ void UMyCharacterMovementComponent::StartStimmy()
 {
 	if (CanStimmy)
 	{
+		TRACE_MOVEMENT_INPUT(*this, EMovementPredictionInput::Stimmy);
 		IsStimmy = true;
-		ServerSetStimmy(IsStimmy);
+		RequestServerStateSync();
 		CanStimmy = false;
-		CurrentMaxRunSpeed *= StimmySpeedMultiplier;
-		DefaultMaxSprintSpeed *= StimmySpeedMultiplier;
-		MaxWalkSpeedCrouched *= StimmySpeedMultiplier;
-		ServerSetStimmySpeed();
 		FTimerHandle FStimmyDuration;
-		GetWorld()->GetTimerManager().SetTimer(FStimmyDuration, this, &UMyCharacterMovementComponent::EndStimmy, StimmyDuration, false);
+		GetWorld()->GetTimerManager().SetTimer(FStimmyDuration, this, &UMyCharacterMovementComponent::EndStimmy, GetTuning().StimmyDuration, false);
 	}
 }
 
-void UMyCharacterMovementComponent::ServerSetStimmySpeed_Implementation()
-{
-	CurrentMaxRunSpeed *= StimmySpeedMultiplier;
-	CurrentMaxSprintSpeed *= StimmySpeedMultiplier;
-	MaxWalkSpeedCrouched *= StimmySpeedMultiplier;
-}
-
-void UMyCharacterMovementComponent::ServerEndStimmySpeed_Implementation()
-{
-	CurrentMaxRunSpeed = DefaultMaxRunSpeed;
-	CurrentMaxSprintSpeed = DefaultMaxSprintSpeed;
-	MaxWalkSpeedCrouched = DefaultMaxWalkSpeedCrouched;
-}
-
 void UMyCharacterMovementComponent::EndStimmy()
 {
 	IsStimmy = false;
-	ServerSetStimmy(IsStimmy);
-	CurrentMaxRunSpeed = DefaultMaxRunSpeed;
-	CurrentMaxSprintSpeed = DefaultMaxSprintSpeed;
-	MaxWalkSpeedCrouched = DefaultMaxWalkSpeedCrouched;
-	ServerEndStimmySpeed();
+	RequestServerStateSync();
 	FTimerHandle FStimmyCooldown;
-	GetWorld()->GetTimerManager().SetTimer(FStimmyCooldown, this, &UMyCharacterMovementComponent::ResetStimmy, StimmyCooldown, false);
+	GetWorld()->GetTimerManager().SetTimer(FStimmyCooldown, this, &UMyCharacterMovementComponent::ResetStimmy, GetTuning().StimmyCooldown, false);
 }
 
 void UMyCharacterMovementComponent::ResetStimmy()
@@ -635,24 +661,22 @@ void UMyCharacterMovementComponent::ResetStimmy()
 	CanStimmy = true;
 }
 
-void UMyCharacterMovementComponent::ServerSetStimmy_Implementation(bool bStimmy)
-{
-	IsStimmy = bStimmy;
-}
-
 #pragma endregion
 
 #pragma region Slide Jump Functions
 
 void UMyCharacterMovementComponent::SlideJump()
 {
-	if (CanSlideJump && IsSliding && MovementMode != MOVE_Falling)
+	if (CanSlideJump && HasMovementModifier(MODIFIER_Slide) && MovementMode != MOVE_Falling)
 	{
+		TRACE_MOVEMENT_INPUT(*this, EMovementPredictionInput::SlideJump);
 		CanSlideJump = false;
-		ServerSlideJump();
+
+		// Sent with the move through FLAG_SlideJump, the engine resends the move if the packet carrying it is lost
+		bWantsToSlideJump = true;
 
 		FTimerHandle FSlideJumpCooldown;
-		GetWorld()->GetTimerManager().SetTimer(FSlideJumpCooldown, this, &UMyCharacterMovementComponent::AllowSlideJump, SlideJumpCooldown, false);
+		GetWorld()->GetTimerManager().SetTimer(FSlideJumpCooldown, this, &UMyCharacterMovementComponent::AllowSlideJump, GetTuning().SlideJumpCooldown, false);
 	}
 }
 
@@ -661,15 +685,18 @@ void UMyCharacterMovementComponent::AllowSlideJump()
 	CanSlideJump = true;
 }
 
-void UMyCharacterMovementComponent::ServerSlideJump_Implementation()
+void UMyCharacterMovementComponent::DoSlideJump()
 {
-	if (IsSliding && MovementMode != MOVE_Falling)
+	// The slide modifier is saved with every move, so replays check the same slide state the move was made with
+	if (HasMovementModifier(MODIFIER_Slide) && MovementMode != MOVE_Falling)
 	{
-		MoveDirection.Normalize();
-		FVector SlideJumpVel = MoveDirection * HorizontalSlideJumpForce;
-		SlideJumpVel.Z = VerticalSlideJumpForce;
+		FVector SlideJumpVel = MoveDirection.GetSafeNormal() * GetTuning().HorizontalSlideJumpForce;
+		SlideJumpVel.Z = GetTuning().VerticalSlideJumpForce;
 		Launch(SlideJumpVel);
-		GravityScale = SlideJumpGravityScale;
+		PushMovementModifier(MODIFIER_SlideJump);
+
+		if (!CharacterOwner->bClientUpdating)
+			AddCosmeticEvent(EVENT_SlideJump);
 	}
 }
 
@@ -683,18 +710,29 @@ void UMyCharacterMovementComponent::FireGrapple(FVector TargetLocation, FVector
 	{
 		if (!IsGrappleInUse())
 		{
+			TRACE_MOVEMENT_INPUT(*this, EMovementPredictionInput::Grapple);
 			const FVector CableStart = GetOwner()->GetActorLocation() + UKismetMathLibrary::TransformDirection(GetOwner()->GetActorTransform(), LocalOffset);
 			const FVector FiringDirection = (TargetLocation - CableStart).GetSafeNormal();
 
 			CableStartLocation = CableStart;
-			ServerFireGrapple(FiringDirection, CableStart);
+
+			// The hook is spawned by the reliable RPC, the flag makes the move it was fired in important so it is sent right away
+			bWantsToGrapple = true;
+			
+			if (GetOwner()->HasAuthority())
+				ServerFireGrapple_Implementation(FiringDirection, CableStart);
+			else
+				ServerFireGrapple(FiringDirection, CableStart);
 		
 			SetGrappleHookState(GRAPPLE_Firing);
 		}
 		else
 		{
 			// End Grapple? Launch?
-			ServerCancelGrapple();
+			if (GetOwner()->HasAuthority())
+				ServerCancelGrapple_Implementation();
+			else
+				ServerCancelGrapple();
 		}
 	}
 }
@@ -747,10 +785,9 @@ void UMyCharacterMovementComponent::OnGrappleHookHit(UPrimitiveComponent* HitCom
 			InitialHookDirection2D.Y = Direction.Y;
 			InitialHookDirection2D.Z = 0.f;
 
-			GroundFriction = 0.f;
-			GravityScale = 0.f;
+			PushMovementModifier(MODIFIER_Grapple);
 
-			Velocity = Direction * InstantaneousVelocityFromGrapple;
+			Velocity = Direction * GetTuning().InstantaneousVelocityFromGrapple;
 		}
 	}
 }
@@ -766,14 +803,12 @@ void UMyCharacterMovementComponent::OnGrappleHookDestroyed(AActor* DestroyedActo
 	if (GetOwner()->GetLocalRole() >ROLE_SimulatedProxy)
 	{
 		SetGrappleHookState(GRAPPLE_Ready);
-
-		GroundFriction = DefaultGroundFriction;
-		GravityScale = DefaultGravityScale;
+		PopMovementModifier(MODIFIER_Grapple);
 	}
 
 	CanGrapple = false;
 	FTimerHandle FGrappleCooldown;
-	GetWorld()->GetTimerManager().SetTimer(FGrappleCooldown, this, &UMyCharacterMovementComponent::AllowGrapple, GrappleCooldown, false);
+	GetWorld()->GetTimerManager().SetTimer(FGrappleCooldown, this, &UMyCharacterMovementComponent::AllowGrapple, GetTuning().GrappleCooldown, false);
 }
 
 void UMyCharacterMovementComponent::SetGrappleHookState(EGrappleHookState NewGrappleHookState)
@@ -781,20 +816,10 @@ void UMyCharacterMovementComponent::SetGrappleHookState(EGrappleHookState NewGra
 	if (CurrentGrappleHookState != NewGrappleHookState)
 	{
 		CurrentGrappleHookState = NewGrappleHookState;
-		ServerSetGrappleHookState(CurrentGrappleHookState);
+		RequestServerStateSync();
 	}
 }
 
-void UMyCharacterMovementComponent::ServerSetGrappleHookState_Implementation(EGrappleHookState NewGrappleHookState)
-{
-	CurrentGrappleHookState = NewGrappleHookState;
-}
-
-bool UMyCharacterMovementComponent::ServerSetGrappleHookState_Validate(EGrappleHookState NewGrappleHookState)
-{
-	return true;
-}
-
 bool UMyCharacterMovementComponent::IsGrappleHookState(EGrappleHookState GrappleHookState)
 {
 	return CurrentGrappleHookState == GrappleHookState;
@@ -817,313 +842,1585 @@ void UMyCharacterMovementComponent::GrappleCableTick()
 		GrappleCable->FollowGrappleHook(GrappleHook, CableStartLocation);
 
 		if (GrappleHook)
-			if (UKismetMathLibrary::Vector_Distance(GetOwner()->GetActorLocation(), GrappleHook->GetActorLocation()) > GrappleDistance)
+			if (UKismetMathLibrary::Vector_Distance(GetOwner()->GetActorLocation(), GrappleHook->GetActorLocation()) > GetTuning().GrappleDistance)
 				GrappleHook->Destroy();
 	}
 }
 
 #pragma endregion 
 
-#pragma region Movement Overrides
+#pragma region Net Update Frequency Functions
 
-void UMyCharacterMovementComponent::BeginPlay()
+bool UMyCharacterMovementComponent::IsInHighVelocityState() const
 {
-	Super::BeginPlay();
-	WallRunSide = kStraight;
-	// We don't want simulated proxies detecting their own collision
-	if (GetPawnOwner()->GetLocalRole() > ROLE_SimulatedProxy)
+	return IsCustomMovementMode(CMOVE_WallRunning) || CurrentGrappleHookState == GRAPPLE_Attached ||
+		HasMovementModifier(MODIFIER_Dodge) || HasMovementModifier(MODIFIER_SlideJump);
+}
+
+void UMyCharacterMovementComponent::SetReplicationBoost(const bool bBoosted)
+{
+	if (bBoosted == bReplicationBoosted)
+		return;
+
+	bReplicationBoosted = bBoosted;
+
+	if (const UNetDriver* NetDriver = GetWorld()->GetNetDriver())
 	{
-		// Bind to the OnActorHot component so we're notified when the owning actor hits something (like a wall)
-		GetPawnOwner()->OnActorHit.AddDynamic(this, &UMyCharacterMovementComponent::OnActorHit);
+		if (UImpulseReplicationGraph* ReplicationGraph = Cast<UImpulseReplicationGraph>(NetDriver->GetReplicationDriver()))
+			ReplicationGraph->SetMovementBoost(GetOwner(), bBoosted);
 	}
 }
 
-void UMyCharacterMovementComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+float UMyCharacterMovementComponent::GetTargetNetUpdateFrequency() const
 {
-	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
-	
-	DOREPLIFETIME(UMyCharacterMovementComponent, IsSliding);
-	
-	//DOREPLIFETIME(UMyCharacterMovementComponent, IsStimmy); ONLY NEED FOR ANIMATION REPLICATION TO OTHER CLIENTS
+	if (IsInHighVelocityState())
+		return HighNetUpdateFrequency;
+
+	if (IsMovingOnGround() && Velocity.SizeSquared() < FMath::Square(IdleSpeedThreshold))
+		return IdleNetUpdateFrequency;
+
+	return MovingNetUpdateFrequency;
 }
 
-FNetworkPredictionData_Client* UMyCharacterMovementComponent::GetPredictionData_Client() const
+bool UMyCharacterMovementComponent::CanGoDormant() const
 {
-	if (ClientPredictionData == nullptr)
-	{
-		// Return our custom client prediction class instead
-		UMyCharacterMovementComponent* MutableThis = const_cast<UMyCharacterMovementComponent*>(this);
-		MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_My(*this);
-	}
+	if (DormancyDelay <= 0.f)
+		return false;
 
-	return ClientPredictionData;
+	const APawn* Pawn = GetPawnOwner();
+	return Pawn && !(Pawn->IsPlayerControlled() && !Pawn->IsLocallyControlled());
 }
 
-void UMyCharacterMovementComponent::SetImpulseMovementMode(const EImpulseMovementMode NewMovementMode)
+void UMyCharacterMovementComponent::UpdateNetUpdateFrequency(float DeltaTime)
 {
-	if (NewMovementMode == ImpulseMovementMode)
+	SCOPE_CYCLE_COUNTER(STAT_MyMovement_UpdateNetUpdateFrequency);
+
+	AActor* Owner = GetOwner();
+
+	// Completely still means no velocity, no input and nothing about to launch the character
+	const bool bStill = IsMovingOnGround() && Velocity.IsZero() && Acceleration.IsZero() && ActiveMovementModifiers == 0 && !IsGrappleInUse();
+	StillTime = bStill ? StillTime + DeltaTime : 0.f;
+
+	// The replication graph ignores NetUpdateFrequency after the actor has been added, it has to be told directly
+	SetReplicationBoost(IsInHighVelocityState());
+
+	if (bStill && StillTime >= DormancyDelay && CanGoDormant())
+	{
+		if (Owner->NetDormancy != DORM_DormantAll)
+			Owner->SetNetDormancy(DORM_DormantAll);
+
+		INC_DWORD_STAT(STAT_MyMovement_DormantCharacters);
+		INC_FLOAT_STAT_BY(STAT_MyMovement_NetUpdatesSaved, HighNetUpdateFrequency);
 		return;
-	
-	ImpulseMovementMode = NewMovementMode;
+	}
 
-	if (PawnOwner->GetLocalRole() > ROLE_SimulatedProxy)
-		ServerSetImpulseMovementMode(NewMovementMode);
+	if (Owner->NetDormancy > DORM_Awake)
+		Owner->SetNetDormancy(DORM_Awake);
+
+	const float TargetFrequency = GetTargetNetUpdateFrequency();
+	if (TargetFrequency > Owner->NetUpdateFrequency)
+	{
+		// Raise the rate straight away so the start of a fast movement is never replicated late
+		Owner->NetUpdateFrequency = TargetFrequency;
+		Owner->ForceNetUpdate();
+	}
+	else
+	{
+		Owner->NetUpdateFrequency = FMath::FInterpTo(Owner->NetUpdateFrequency, TargetFrequency, DeltaTime, NetUpdateFrequencyInterpSpeed);
+	}
+
+	INC_FLOAT_STAT_BY(STAT_MyMovement_NetUpdateFrequency, Owner->NetUpdateFrequency);
+	INC_FLOAT_STAT_BY(STAT_MyMovement_NetUpdatesSaved, HighNetUpdateFrequency - Owner->NetUpdateFrequency);
 }
 
-void UMyCharacterMovementComponent::ServerSetImpulseMovementMode_Implementation(EImpulseMovementMode NewMoveMode)
+#pragma endregion
+
+#pragma region Cosmetic Event Functions
+
+void UMyCharacterMovementComponent::AddCosmeticEvent(const EMovementCosmeticEvent Event)
 {
-	MultiSetImpulseMovementMode(NewMoveMode);
+	++CosmeticEventCounts[Event];
+
+	if (GetOwner()->HasAuthority())
+		PendingCosmeticEvents |= 1 << Event;
 }
 
-bool UMyCharacterMovementComponent::ServerSetImpulseMovementMode_Validate(EImpulseMovementMode NewMoveMode)
+void UMyCharacterMovementComponent::FlushCosmeticEvents()
 {
-	return true;
+	if (PendingCosmeticEvents == 0)
+		return;
+
+	INC_DWORD_STAT(STAT_MyMovement_CosmeticEventBatchesSent);
+
+	MultiCosmeticEvents(++CosmeticEventSequence, PendingCosmeticEvents);
+	PendingCosmeticEvents = 0;
 }
 
-void UMyCharacterMovementComponent::MultiSetImpulseMovementMode_Implementation(EImpulseMovementMode NewMoveMode)
+void UMyCharacterMovementComponent::MultiCosmeticEvents_Implementation(const uint8 Sequence, const uint8 Events)
 {
-	ImpulseMovementMode = NewMoveMode;
+	// The server and the owning client already recorded these events when they happened
+	if (GetOwner()->GetLocalRole() != ROLE_SimulatedProxy)
+		return;
+
+	// Unreliable batches can arrive out of order or twice, anything that is not newer than the last batch is dropped
+	if (bReceivedCosmeticEvent && static_cast<int8>(Sequence - LastReceivedCosmeticEventSequence) <= 0)
+	{
+		INC_DWORD_STAT(STAT_MyMovement_CosmeticEventBatchesDropped);
+		return;
+	}
+
+	bReceivedCosmeticEvent = true;
+	LastReceivedCosmeticEventSequence = Sequence;
+
+	for (uint8 Event = 0; Event < EVENT_MAX; ++Event)
+	{
+		if (Events & (1 << Event))
+			++CosmeticEventCounts[Event];
+	}
+
+	PushDiscreteMovementState();
 }
 
-bool UMyCharacterMovementComponent::MultiSetImpulseMovementMode_Validate(EImpulseMovementMode NewMoveMode)
+#pragma endregion
+
+#pragma region Discrete Movement State Functions
+
+FDiscreteMovementState UMyCharacterMovementComponent::MakeDiscreteMovementState() const
 {
-	return true;
+	FDiscreteMovementState State;
+	State.ImpulseMovementMode = ImpulseMovementMode;
+	State.WallRunSide = WallRunSide;
+	// Simulated proxies only have the replicated IsSliding, the owner and the server have the predicted slide modifier
+	State.IsSliding = GetOwner() && GetOwner()->GetLocalRole() == ROLE_SimulatedProxy ? IsSliding : HasMovementModifier(MODIFIER_Slide);
+	FMemory::Memcpy(State.CosmeticEventCounts, CosmeticEventCounts, sizeof(CosmeticEventCounts));
+	return State;
 }
 
-void UMyCharacterMovementComponent::OnComponentDestroyed(bool DestroyingHierarchy)
+void UMyCharacterMovementComponent::PushDiscreteMovementState()
 {
-	if (GetPawnOwner() != nullptr && GetPawnOwner()->GetLocalRole() > ROLE_SimulatedProxy)
+	if (!GetOwner() || GetOwner()->GetLocalRole() != ROLE_SimulatedProxy)
+		return;
+
+	// Make room by applying the oldest state early rather than losing it
+	if (DiscreteStateCount == DiscreteStateBufferSize)
 	{
-		// Unbind from all events
-		GetPawnOwner()->OnActorHit.RemoveDynamic(this, &UMyCharacterMovementComponent::OnActorHit);
+		InterpolatedDiscreteState = DiscreteStateBuffer[DiscreteStateHead].State;
+		DiscreteStateHead = (DiscreteStateHead + 1) % DiscreteStateBufferSize;
+		--DiscreteStateCount;
 	}
 
-	Super::OnComponentDestroyed(DestroyingHierarchy);
+	FDiscreteMovementSnapshot& Snapshot = DiscreteStateBuffer[(DiscreteStateHead + DiscreteStateCount) % DiscreteStateBufferSize];
+	Snapshot.ReceiveTime = GetWorld()->GetTimeSeconds();
+	Snapshot.State = MakeDiscreteMovementState();
+	++DiscreteStateCount;
 }
 
-void UMyCharacterMovementComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+void UMyCharacterMovementComponent::UpdateDiscreteMovementState()
 {
-	// Perform local only checks
-	if (GetPawnOwner()->IsLocallyControlled())
-		CameraTick();
-	
-	if (IsGrappleInUse())
-		GrappleCableTick();
-	
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	// The location of simulated proxies is smoothed over NetworkSimulatedSmoothLocationTime, apply the state with the same delay
+	const double RenderTime = GetWorld()->GetTimeSeconds() - (NetworkSmoothingMode == ENetworkSmoothingMode::Disabled ? 0.f : NetworkSimulatedSmoothLocationTime);
+
+	while (DiscreteStateCount > 0 && DiscreteStateBuffer[DiscreteStateHead].ReceiveTime <= RenderTime)
+	{
+		InterpolatedDiscreteState = DiscreteStateBuffer[DiscreteStateHead].State;
+		DiscreteStateHead = (DiscreteStateHead + 1) % DiscreteStateBufferSize;
+		--DiscreteStateCount;
+	}
 }
 
-void UMyCharacterMovementComponent::UpdateFromCompressedFlags(uint8 Flags)
+FDiscreteMovementState UMyCharacterMovementComponent::GetDiscreteMovementState() const
 {
-	Super::UpdateFromCompressedFlags(Flags);
+	if (GetOwner() && GetOwner()->GetLocalRole() == ROLE_SimulatedProxy)
+		return InterpolatedDiscreteState;
 
-	/*  There are 4 custom move flags for us to use. Below is what each is currently being used for:
-		FLAG_Custom_0		= 0x10, // Sprinting
-		FLAG_Custom_1		= 0x20, // WallRunning
-		FLAG_Custom_2		= 0x40, // Unused
-		FLAG_Custom_3		= 0x80, // Unused
-	*/
+	return MakeDiscreteMovementState();
+}
 
-	// Read the values from the compressed flags
-	WantsToSprint = (Flags & FSavedMove_MyMovement::FLAG_Sprint) != 0;
+#pragma endregion
+
+#pragma region Proxy Extrapolation Functions
+
+void UMyCharacterMovementComponent::UpdateProxyExtrapolation()
+{
+	if (CurrentGrappleHookState == GRAPPLE_Attached && GrappleHook)
+	{
+		ProxyExtrapolationModel = EXTRAPOLATE_Grapple;
+		ProxyExtrapolationAnchor = GrappleHook->GetActorLocation();
+	}
+	else if (IsCustomMovementMode(CMOVE_WallRunning))
+	{
+		ProxyExtrapolationModel = EXTRAPOLATE_WallRun;
+		ProxyExtrapolationDirection = WallRunDirection;
+	}
+	else if (HasMovementModifier(MODIFIER_SlideJump) && IsFalling())
+	{
+		ProxyExtrapolationModel = EXTRAPOLATE_SlideJump;
+	}
+	else if (HasMovementModifier(MODIFIER_Slide) && IsMovingOnGround())
+	{
+		ProxyExtrapolationModel = EXTRAPOLATE_Slide;
+		ProxyExtrapolationDirection = CurrentFloor.HitResult.ImpactNormal;
+	}
+	else
+	{
+		ProxyExtrapolationModel = EXTRAPOLATE_Default;
+	}
+}
+
+void UMyCharacterMovementComponent::ExtrapolateProxy(float DeltaTime)
+{
+	ProxyExtrapolationTime += DeltaTime;
+
+	// Hold the last position rather than drifting further away from where the server may have stopped the character
+	if (ProxyExtrapolationTime > MaxProxyExtrapolationTime)
+		return;
+
+	switch (ProxyExtrapolationModel)
+	{
+		case EXTRAPOLATE_WallRun:
+			{
+				Velocity = ProxyExtrapolationDirection * Velocity.Size2D();
+				break;
+			}
+		case EXTRAPOLATE_Grapple:
+			{
+				const FVector Direction = (ProxyExtrapolationAnchor - UpdatedComponent->GetComponentLocation()).GetSafeNormal();
+				Velocity += Direction * (GetTuning().GrapplePullForce / Mass) * DeltaTime;
+				break;
+			}
+		case EXTRAPOLATE_Slide:
+			{
+				// Only the part of gravity along the slope accelerates the slide, there is no friction while sliding
+				const FVector Gravity(0.f, 0.f, GetGravityZ());
+				Velocity += FVector::VectorPlaneProject(Gravity, ProxyExtrapolationDirection) * DeltaTime;
+				Velocity = FVector::VectorPlaneProject(Velocity, ProxyExtrapolationDirection);
+				break;
+			}
+		case EXTRAPOLATE_SlideJump:
+			{
+				Velocity.Z += GetWorld()->GetGravityZ() * GetTuning().SlideJumpGravityScale * DeltaTime;
+				break;
+			}
+		default:
+			{
+				break;
+			}
+	}
+
+	FHitResult Hit(1.f);
+	SafeMoveUpdatedComponent(Velocity * DeltaTime, UpdatedComponent->GetComponentQuat(), true, Hit);
+
+	if (Hit.IsValidBlockingHit())
+		Velocity = FVector::VectorPlaneProject(Velocity, Hit.Normal);
+}
+
+#pragma endregion
+
+#pragma region Simulated Proxy Functions
+
+void UMyCharacterMovementComponent::TickSimulatedProxy(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	SCOPE_CYCLE_COUNTER(STAT_MyMovement_SimulatedProxyTick);
+	INC_DWORD_STAT(STAT_MyMovement_SimulatedProxiesTicked);
+
+	UpdateDiscreteMovementState();
+	
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+}
+
+#pragma endregion
+
+#pragma region Server Controlled AI Functions
+
+bool UMyCharacterMovementComponent::IsServerControlledAI() const
+{
+	return GetOwner()->HasAuthority() && PawnOwner && PawnOwner->GetController() && !PawnOwner->IsPlayerControlled();
+}
+
+void UMyCharacterMovementComponent::TickServerControlledAI(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	SCOPE_CYCLE_COUNTER(STAT_MyMovement_ServerControlledAITick);
+	INC_DWORD_STAT(STAT_MyMovement_ServerControlledAITicked);
+	
+	if (IsGrappleInUse())
+		GrappleCableTick();
+
+	if (GetNetMode() != NM_Standalone)
+	{
+		UpdateNetUpdateFrequency(DeltaTime);
+		UpdateProxyExtrapolation();
+		UpdateMovementNetState();
+	}
+
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	FlushServerControlledAIState();
+	FlushCosmeticEvents();
+}
+
+void UMyCharacterMovementComponent::FlushServerControlledAIState()
+{
+	// The rest of the server state is only read on the server, which already has it
+	PendingServerStateRequests = 0;
+
+	if (WallRunSide != LastServerState.WallRunSide)
+	{
+		LastServerState.WallRunSide = WallRunSide;
+		SetReplicatedWallRunSide(WallRunSide);
+	}
+	
+	if (ImpulseMovementMode.GetValue() != LastServerState.ImpulseMovementMode)
+	{
+		LastServerState.ImpulseMovementMode = ImpulseMovementMode;
+		SetReplicatedImpulseMovementMode(ImpulseMovementMode);
+	}
+}
+
+#pragma endregion
+
+#pragma region Fixed Tick Simulation Functions
+
+int32 UMyCharacterMovementComponent::GetFixedTicksInMove(const float DeltaSeconds)
+{
+	// The tolerance only absorbs the float error of moves that are whole ticks
+	const float Ticks = DeltaSeconds * FixedTickRate + FixedTickMoveRemainder;
+	const int32 NumTicks = FMath::FloorToInt(Ticks + UE_KINDA_SMALL_NUMBER);
+	FixedTickMoveRemainder = FMath::Max(Ticks - NumTicks, 0.f);
+	return NumTicks;
+}
+
+void UMyCharacterMovementComponent::TickFixed(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	FixedTickAccumulator += DeltaTime;
+
+	const float FixedTickTime = GetFixedTickTime();
+	int32 NumTicks = FMath::FloorToInt(FixedTickAccumulator / FixedTickTime);
+	if (NumTicks > MaxFixedTicksPerFrame)
+	{
+		INC_DWORD_STAT_BY(STAT_MyMovement_FixedTicksDropped, NumTicks - MaxFixedTicksPerFrame);
+		NumTicks = MaxFixedTicksPerFrame;
+		FixedTickAccumulator = NumTicks * FixedTickTime;
+	}
+
+	// Input keeps accumulating on the pawn until the next frame that has a whole tick to simulate
+	if (NumTicks > 0)
+	{
+		INC_DWORD_STAT_BY(STAT_MyMovement_FixedTicks, NumTicks);
+		FixedTickAccumulator -= NumTicks * FixedTickTime;
+
+		// MaxSimulationTimeStep is one fixed tick, so PerformMovement steps the ticks one by one on both the client and the server
+		Super::TickComponent(NumTicks * FixedTickTime, TickType, ThisTickFunction);
+	}
+
+	UpdateFixedTickRenderOffset();
+}
+
+void UMyCharacterMovementComponent::AdvanceFixedTickAbilities(const float DeltaSeconds)
+{
+	const int32 NumTicks = GetFixedTicksInMove(DeltaSeconds);
+
+	if (DodgeTicksRemaining > 0)
+	{
+		DodgeTicksRemaining = static_cast<uint8>(FMath::Max(DodgeTicksRemaining - NumTicks, 0));
+		if (DodgeTicksRemaining == 0)
+			EndDodge();
+	}
+
+	// The slide modifier is predicted and saved with every move, the owning client and the server apply the forces on the same ticks
+	if (HasMovementModifier(MODIFIER_Slide))
+	{
+		// Same interval as the slide timer of the variable tick simulation
+		const int32 SlideForceInterval = FMath::Max(FMath::RoundToInt(0.5f * FixedTickRate), 1);
+		
+		int32 Ticks = SlideForceTicks + NumTicks;
+		while (Ticks >= SlideForceInterval)
+		{
+			Ticks -= SlideForceInterval;
+			const bool bStillSliding = ApplySlideForce();
+
+			// Ending the slide is up to the owning client, the server follows once the slide flag of the moves clears
+			if (bWantsToSlide && CharacterOwner->IsLocallyControlled() && !CharacterOwner->bClientUpdating && (!bStillSliding || !SlideKeysDown || !IsMovingForward()))
+				EndSlide();
+		}
+		SlideForceTicks = static_cast<uint8>(Ticks);
+	}
+	else
+		SlideForceTicks = 0;
+}
+
+void UMyCharacterMovementComponent::UpdateFixedTickRenderOffset()
+{
+	if (!CharacterOwner || !CharacterOwner->GetMesh() || !UpdatedComponent)
+		return;
+
+	// Render the character the carried part of a tick after the previous tick, which is approximated from the velocity
+	const float Alpha = FixedTickAccumulator / GetFixedTickTime();
+	FixedTickRenderOffset = -Velocity * GetFixedTickTime() * (1.f - Alpha);
+
+	const FVector LocalOffset = UpdatedComponent->GetComponentTransform().InverseTransformVectorNoScale(FixedTickRenderOffset);
+	CharacterOwner->GetMesh()->SetRelativeLocation(CharacterOwner->GetBaseTranslationOffset() + LocalOffset);
+}
+
+#pragma endregion
+
+#pragma region Packed Movement State Functions
+
+void UMyCharacterMovementComponent::OnRep_MovementNetState()
+{
+	const bool bDiscreteStateChanged = WallRunSide != MovementNetState.WallRunSide
+		|| ImpulseMovementMode.GetValue() != MovementNetState.ImpulseMovementMode
+		|| IsSliding != MovementNetState.IsSliding;
+
+	WallRunSide = static_cast<EWallRunSide>(MovementNetState.WallRunSide);
+	ImpulseMovementMode = static_cast<EImpulseMovementMode>(MovementNetState.ImpulseMovementMode);
+	IsSliding = MovementNetState.IsSliding;
+
+	ProxyExtrapolationModel = MovementNetState.ProxyExtrapolationModel;
+	ProxyExtrapolationDirection = MovementNetState.ProxyExtrapolationDirection;
+	ProxyExtrapolationAnchor = MovementNetState.ProxyExtrapolationAnchor;
+
+	// Same buffering as the multicasts, so the animations see the state change with the location it happened at
+	if (bDiscreteStateChanged)
+		PushDiscreteMovementState();
+}
+
+void UMyCharacterMovementComponent::UpdateMovementNetState()
+{
+	if (!bUsePackedMovementState)
+		return;
+
+	FMyMovementNetState NewState;
+	NewState.WallRunSide = WallRunSide;
+	NewState.ImpulseMovementMode = ImpulseMovementMode.GetValue();
+	NewState.IsSliding = IsSliding;
+	NewState.ProxyExtrapolationModel = ProxyExtrapolationModel;
+
+	// Unused vectors are left at zero so they never make the state differ
+	if (NewState.UsesExtrapolationDirection())
+		NewState.ProxyExtrapolationDirection = ProxyExtrapolationDirection;
+	if (NewState.UsesExtrapolationAnchor())
+		NewState.ProxyExtrapolationAnchor = ProxyExtrapolationAnchor;
+
+	if (NewState != MovementNetState)
+		MovementNetState = NewState;
+}
+
+void UMyCharacterMovementComponent::SetReplicatedWallRunSide(const EWallRunSide Side)
+{
+	if (bUsePackedMovementState)
+		WallRunSide = Side;
+	else
+		MultiSetWallRunSide(Side);
+}
+
+void UMyCharacterMovementComponent::SetReplicatedImpulseMovementMode(const EImpulseMovementMode NewMoveMode)
+{
+	if (bUsePackedMovementState)
+		ImpulseMovementMode = NewMoveMode;
+	else
+		MultiSetImpulseMovementMode(NewMoveMode);
+}
+
+void UMyCharacterMovementComponent::MoveAutonomous(float ClientTimeStamp, float DeltaTime, uint8 CompressedFlags, const FVector& NewAccel)
+{
+	if (bUsePackedMovementState)
+	{
+		if (const FMyCharacterNetworkMoveData* MoveData = static_cast<const FMyCharacterNetworkMoveData*>(GetCurrentNetworkMoveData()))
+			MoveDirection = MoveData->MoveDirection;
+	}
+
+	Super::MoveAutonomous(ClientTimeStamp, DeltaTime, CompressedFlags, NewAccel);
+}
+
+#pragma endregion
+
+#pragma region Client Move Send Rate Functions
+
+bool UMyCharacterMovementComponent::IsMovingInStraightLine() const
+{
+	if (!IsMovingOnGround() || Acceleration.IsNearlyZero())
+		return false;
+
+	return (Acceleration.GetSafeNormal2D() | Velocity.GetSafeNormal2D()) >= StraightLineDotThreshold;
+}
+
+float UMyCharacterMovementComponent::GetClientNetSendDeltaTime(const APlayerController* PC, const FNetworkPredictionData_Client_Character* ClientData, const FSavedMovePtr& NewMove) const
+{
+	const float BaseDeltaTime = Super::GetClientNetSendDeltaTime(PC, ClientData, NewMove);
+
+	// Anything above the engine default was raised by the engine for a low net speed or a busy server, and is kept as it is
+	if (IsInHighVelocityState())
+	{
+		const float DefaultDeltaTime = GetDefault<AGameNetworkManager>()->ClientNetSendMoveDeltaTime;
+		return BaseDeltaTime > DefaultDeltaTime ? BaseDeltaTime : FMath::Min(BaseDeltaTime, HighVelocitySendDeltaTime);
+	}
+
+	float NetSendDeltaTime = BaseDeltaTime;
+	if (IsMovingInStraightLine())
+		NetSendDeltaTime = FMath::Max(NetSendDeltaTime, StraightLineSendDeltaTime);
+
+	if (PC && PC->PlayerState && PingForMaxSendDeltaTimeScale > 0.f)
+	{
+		const float PingAlpha = FMath::Clamp(PC->PlayerState->GetPingInMilliseconds() / PingForMaxSendDeltaTimeScale, 0.f, 1.f);
+		NetSendDeltaTime *= FMath::Lerp(1.f, MaxPingSendDeltaTimeScale, PingAlpha);
+	}
+
+	return NetSendDeltaTime;
+}
+
+bool UMyCharacterMovementComponent::CanDelaySendingMove(const FSavedMovePtr& NewMove)
+{
+	if (!Super::CanDelaySendingMove(NewMove))
+		return false;
+
+	const FNetworkPredictionData_Client_Character* ClientData = GetPredictionData_Client_Character();
+	if (!ClientData)
+		return true;
+
+	// Compare with the move before this one rather than the last acked move, which would hold every move for a round trip.
+	// The new move is already the last saved move, the one before it was sent unless it is still pending.
+	const FSavedMove_Character* PreviousMove = ClientData->PendingMove.Get();
+	if (!PreviousMove && ClientData->SavedMoves.Num() >= 2)
+		PreviousMove = ClientData->SavedMoves.Last(1).Get();
+	if (!PreviousMove)
+		PreviousMove = ClientData->LastAckedMove.Get();
+	if (!PreviousMove)
+		return true;
+
+	// Every ability start changes the compressed flags, the server has to see those and movement mode changes early
+	if (NewMove->GetCompressedFlags() != PreviousMove->GetCompressedFlags() || NewMove->EndPackedMovementMode != PreviousMove->EndPackedMovementMode)
+	{
+		INC_DWORD_STAT(STAT_MyMovement_MovesSentImmediately);
+		return false;
+	}
+
+	return true;
+}
+
+#pragma endregion
+
+#pragma region Server Move Buffer Functions
+
+void UMyCharacterMovementComponent::UpdateServerMoveBuffer(float DeltaTime)
+{
+	if (!bUseServerMoveBuffer || !GetPawnOwner() || GetPawnOwner()->IsLocallyControlled())
+		return;
+
+	const int32 Depth = BufferedServerMoves.Num();
+	AverageServerMoveBufferDepth = FMath::Lerp(AverageServerMoveBufferDepth, static_cast<float>(Depth), FMath::Min(DeltaTime * 2.f, 1.f));
+	INC_DWORD_STAT_BY(STAT_MyMovement_ServerMoveBufferDepth, Depth);
+	INC_FLOAT_STAT_BY(STAT_MyMovement_ServerMoveBufferDelay, ServerMoveBufferDelay * 1000.f);
+
+	if (!bServerMovePlayoutStarted)
+		return;
+
+	// The playout time keeps running while the buffer is empty, moves that arrive late are performed right away
+	ServerMovePlayoutTime += DeltaTime;
+
+	// Release the moves that are due, plus whatever is past the max depth
+	int32 NumToRelease = FMath::Max(Depth - MaxServerMoveBufferDepth, 0);
+	while (NumToRelease < Depth && BufferedServerMoves[NumToRelease].TimeStamp <= ServerMovePlayoutTime)
+		NumToRelease++;
+
+	const double Now = GetWorld()->GetRealTimeSeconds();
+	for (int32 i = 0; i < NumToRelease; i++)
+	{
+		ServerMoveBufferDelay = FMath::Lerp(ServerMoveBufferDelay, static_cast<float>(Now - BufferedServerMoves[i].ReceiveTime), 0.1f);
+		Super::ServerMovePacked_ServerReceive(BufferedServerMoves[i].PackedBits);
+	}
+	BufferedServerMoves.RemoveAt(0, NumToRelease);
+
+	// A client running behind the playout time arrives late and empties the buffer, speed it up. One running ahead fills it, slow it down.
+	ClientMoveRateSendTime += DeltaTime;
+	if (ClientMoveRateSendTime >= ClientMoveRateSendInterval)
+	{
+		ClientMoveRateSendTime = 0.f;
+
+		const float Error = TargetServerMoveBufferDelay > 0.f ? (TargetServerMoveBufferDelay - ServerMoveBufferDelay) / TargetServerMoveBufferDelay : -ServerMoveBufferDelay;
+		ClientMoveRate = 1.f + FMath::Clamp(Error * MaxClientMoveRateAdjustment, -MaxClientMoveRateAdjustment, MaxClientMoveRateAdjustment);
+		ClientSetMoveRate(ClientMoveRate);
+	}
+}
+
+bool UMyCharacterMovementComponent::ReadServerMoveTimeStamp(const FCharacterServerMovePackedBits& PackedBits, float& OutTimeStamp)
+{
+	// Deserialized into the same container the move is performed from later, which reads it again when it is released
+	FNetBitReader Ar(PackedBits.GetPackageMap(), (uint8*)PackedBits.DataBits.GetData(), PackedBits.DataBits.Num());
+
+	FCharacterNetworkMoveDataContainer& MoveDataContainer = GetNetworkMoveDataContainer();
+	if (!MoveDataContainer.Serialize(*this, Ar, Ar.PackageMap) || Ar.IsError())
+		return false;
+
+	OutTimeStamp = MoveDataContainer.GetNewMoveData()->TimeStamp;
+	return true;
+}
+
+void UMyCharacterMovementComponent::ClientSetMoveRate_Implementation(float MoveRate)
+{
+	ClientMoveRate = FMath::Clamp(MoveRate, 1.f - MaxClientMoveRateAdjustment, 1.f + MaxClientMoveRateAdjustment);
+}
+
+void UMyCharacterMovementComponent::ServerMovePacked_ServerReceive(const FCharacterServerMovePackedBits& PackedBits)
+{
+	float TimeStamp = 0.f;
+	if (!bUseServerMoveBuffer || !ReadServerMoveTimeStamp(PackedBits, TimeStamp))
+	{
+		Super::ServerMovePacked_ServerReceive(PackedBits);
+		return;
+	}
+
+	// The client resets its time stamps every so often, perform what is left of the old ones and start over
+	if (bServerMovePlayoutStarted && LastServerMoveTimeStamp - TimeStamp > MinTimeBetweenTimeStampResets * 0.5f)
+	{
+		for (const FBufferedServerMove& BufferedMove : BufferedServerMoves)
+			Super::ServerMovePacked_ServerReceive(BufferedMove.PackedBits);
+		BufferedServerMoves.Reset();
+		bServerMovePlayoutStarted = false;
+	}
+
+	if (!bServerMovePlayoutStarted)
+	{
+		ServerMovePlayoutTime = TimeStamp - TargetServerMoveBufferDelay;
+		bServerMovePlayoutStarted = true;
+	}
+	LastServerMoveTimeStamp = TimeStamp;
+
+	FBufferedServerMove& BufferedMove = BufferedServerMoves.AddDefaulted_GetRef();
+	BufferedMove.ReceiveTime = GetWorld()->GetRealTimeSeconds();
+	BufferedMove.TimeStamp = TimeStamp;
+	BufferedMove.PackedBits = PackedBits;
+}
+
+#pragma endregion
+
+#pragma region Movement Overrides
+
+void UMyCharacterMovementComponent::BeginPlay()
+{
+	Super::BeginPlay();
+	WallRunSide = kStraight;
+	InterpolatedDiscreteState = MakeDiscreteMovementState();
+	// Simulated proxies take the cheaper tick path, which can run in a later tick group
+	if (GetPawnOwner()->GetLocalRole() == ROLE_SimulatedProxy)
+		SetTickGroup(SimulatedProxyTickGroup);
+	
+	// We don't want simulated proxies detecting their own collision
+	if (GetPawnOwner()->GetLocalRole() > ROLE_SimulatedProxy)
+	{
+		// Bind to the OnActorHot component so we're notified when the owning actor hits something (like a wall)
+		GetPawnOwner()->OnActorHit.AddDynamic(this, &UMyCharacterMovementComponent::OnActorHit);
+	}
+}
+
+void UMyCharacterMovementComponent::InitializeComponent()
+{
+	Super::InitializeComponent();
+
+	// The tuning asset is only known once the properties of the component have been loaded
+	Tuning = MovementTuning ? MovementTuning : GetDefault<UMyMovementTuning>();
+	ApplyTuning();
+
+	if (bUsePackedMovementState)
+		SetNetworkMoveDataContainer(MoveDataContainer);
+
+	// Every move lasts whole fixed ticks, stepping by one tick makes the server step a combined move exactly like the client stepped its parts
+	if (bUseFixedTickSimulation)
+	{
+		MaxSimulationTimeStep = GetFixedTickTime();
+		MaxSimulationIterations = FMath::Max(MaxSimulationIterations, MaxFixedTicksPerFrame);
+	}
+}
+
+void UMyCharacterMovementComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+	
+	// The conditions are registered once for the class, PreReplication turns off the path an instance does not use
+	DOREPLIFETIME(UMyCharacterMovementComponent, IsSliding);
+	DOREPLIFETIME_CONDITION(UMyCharacterMovementComponent, ProxyExtrapolationModel, COND_SimulatedOnly);
+	DOREPLIFETIME_CONDITION(UMyCharacterMovementComponent, ProxyExtrapolationDirection, COND_SimulatedOnly);
+	DOREPLIFETIME_CONDITION(UMyCharacterMovementComponent, ProxyExtrapolationAnchor, COND_SimulatedOnly);
+	DOREPLIFETIME_CONDITION(UMyCharacterMovementComponent, MovementNetState, COND_SimulatedOnly);
+	
+	//DOREPLIFETIME(UMyCharacterMovementComponent, IsStimmy); ONLY NEED FOR ANIMATION REPLICATION TO OTHER CLIENTS
+}
+
+void UMyCharacterMovementComponent::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker)
+{
+	Super::PreReplication(ChangedPropertyTracker);
+
+	// Only one of the two paths is ever replicated, the other one is never sent
+	DOREPLIFETIME_ACTIVE_OVERRIDE(UMyCharacterMovementComponent, IsSliding, !bUsePackedMovementState);
+	DOREPLIFETIME_ACTIVE_OVERRIDE(UMyCharacterMovementComponent, ProxyExtrapolationModel, !bUsePackedMovementState);
+	DOREPLIFETIME_ACTIVE_OVERRIDE(UMyCharacterMovementComponent, ProxyExtrapolationDirection, !bUsePackedMovementState);
+	DOREPLIFETIME_ACTIVE_OVERRIDE(UMyCharacterMovementComponent, ProxyExtrapolationAnchor, !bUsePackedMovementState);
+	DOREPLIFETIME_ACTIVE_OVERRIDE(UMyCharacterMovementComponent, MovementNetState, bUsePackedMovementState);
+}
+
+FNetworkPredictionData_Client* UMyCharacterMovementComponent::GetPredictionData_Client() const
+{
+	if (ClientPredictionData == nullptr)
+	{
+		// Return our custom client prediction class instead
+		UMyCharacterMovementComponent* MutableThis = const_cast<UMyCharacterMovementComponent*>(this);
+		MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_My(*this);
+	}
+
+	return ClientPredictionData;
+}
+
+void UMyCharacterMovementComponent::SetImpulseMovementMode(const EImpulseMovementMode NewMovementMode)
+{
+	if (NewMovementMode == ImpulseMovementMode)
+		return;
+	
+	ImpulseMovementMode = NewMovementMode;
+
+	if (PawnOwner->GetLocalRole() > ROLE_SimulatedProxy)
+		RequestServerStateSync();
+}
+
+void UMyCharacterMovementComponent::MultiSetImpulseMovementMode_Implementation(EImpulseMovementMode NewMoveMode)
+{
+	ImpulseMovementMode = NewMoveMode;
+	PushDiscreteMovementState();
+}
+
+bool UMyCharacterMovementComponent::MultiSetImpulseMovementMode_Validate(EImpulseMovementMode NewMoveMode)
+{
+	return true;
+}
+
+void UMyCharacterMovementComponent::OnComponentDestroyed(bool DestroyingHierarchy)
+{
+	if (GetPawnOwner() != nullptr && GetPawnOwner()->GetLocalRole() > ROLE_SimulatedProxy)
+	{
+		// Unbind from all events
+		GetPawnOwner()->OnActorHit.RemoveDynamic(this, &UMyCharacterMovementComponent::OnActorHit);
+	}
+
+	Super::OnComponentDestroyed(DestroyingHierarchy);
+}
+
+void UMyCharacterMovementComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	InvalidateSpeedState();
+
+	if (GetOwner()->GetLocalRole() == ROLE_SimulatedProxy)
+	{
+		TickSimulatedProxy(DeltaTime, TickType, ThisTickFunction);
+		return;
+	}
+
+	if (IsServerControlledAI())
+	{
+		TickServerControlledAI(DeltaTime, TickType, ThisTickFunction);
+		return;
+	}
+	
+	// Perform local only checks
+	if (GetPawnOwner()->IsLocallyControlled() && !CameraModifier.IsValid())
+		AddCameraModifier();
+
+	// The server move buffer has the owning client run its moves slightly faster or slower, which moves its time stamps with them
+	if (GetOwner()->GetLocalRole() == ROLE_AutonomousProxy)
+		DeltaTime *= ClientMoveRate;
+
+	const bool bTickFixed = bUseFixedTickSimulation && GetPawnOwner()->IsLocallyControlled();
+	
+	if (IsGrappleInUse())
+		GrappleCableTick();
+
+	// Perform server only checks
+	if (GetOwner()->HasAuthority() && GetNetMode() != NM_Standalone)
+	{
+		UpdateNetUpdateFrequency(DeltaTime);
+		UpdateProxyExtrapolation();
+		UpdateMovementNetState();
+		UpdateServerMoveBuffer(DeltaTime);
+	}
+	
+	if (bTickFixed)
+		TickFixed(DeltaTime, TickType, ThisTickFunction);
+	else
+		Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	// Send everything that changed this frame, including during the movement update, in a single RPC
+	if (GetOwner()->GetLocalRole() > ROLE_SimulatedProxy)
+		FlushServerState();
+
+	if (GetOwner()->HasAuthority())
+		FlushCosmeticEvents();
+}
+
+void UMyCharacterMovementComponent::UpdateFromCompressedFlags(uint8 Flags)
+{
+	Super::UpdateFromCompressedFlags(Flags);
+
+	/*  Below is what each of the move flags we use is currently being used for:
+		FLAG_Reserved_1		= 0x04, // Sprinting
+		FLAG_Reserved_2		= 0x08, // WallRunning
+		FLAG_Custom_0		= 0x10, // Sliding
+		FLAG_Custom_1		= 0x20, // Blinking
+		FLAG_Custom_2		= 0x40, // SlideJumping
+		FLAG_Custom_3		= 0x80, // Grappling
+	*/
+
+	// Read the values from the compressed flags
+	WantsToSprint = (Flags & FSavedMove_MyMovement::FLAG_Sprint) != 0;
 	WallRunKeysDown = (Flags & FSavedMove_MyMovement::FLAG_WallRun) != 0;
+	bWantsToSlide = (Flags & FSavedMove_MyMovement::FLAG_Slide) != 0;
 	bWantsToDodge = (Flags & FSavedMove_MyMovement::FLAG_3) != 0;
+	bWantsToSlideJump = (Flags & FSavedMove_MyMovement::FLAG_SlideJump) != 0;
+	bWantsToGrapple = (Flags & FSavedMove_MyMovement::FLAG_Grapple) != 0;
+}
+
+void UMyCharacterMovementComponent::OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode)
+{
+	InvalidateSpeedState();
+
+	if (PreviousMovementMode == MovementMode && PreviousCustomMode == CustomMovementMode)
+	{
+		Super::OnMovementModeChanged(PreviousMovementMode, PreviousCustomMode);
+		return;
+	}
+	
+#pragma region Leaving State Handlers
+	
+	if (PreviousMovementMode == MOVE_Custom && PreviousCustomMode == CMOVE_WallRunning)
+	{
+		PopMovementModifier(MODIFIER_SlideJump); //in case slide jump to a wall
+		bConstrainToPlane = false;
+	}
+	
+#pragma endregion
+	
+#pragma region Entering State Handlers
+
+	if (MovementMode == MOVE_Walking || MovementMode == MOVE_NavWalking)
+	{
+		SetImpulseMovementMode(CMOVE_Grounded);
+	}
+	if (MovementMode == MOVE_Falling)
+	{
+		SetImpulseMovementMode(CMOVE_InAir);
+	}
+	
+	if (IsCustomMovementMode(CMOVE_WallRunning))
+	{
+		SetImpulseMovementMode(CMOVE_WallRunning);
+		StopMovementImmediately();
+		bConstrainToPlane = true;
+		SetPlaneConstraintNormal(FVector(0.0f, 0.0f, 1.0f));
+	}
+
+#pragma endregion 
+
+	Super::OnMovementModeChanged(PreviousMovementMode, PreviousCustomMode);
+	
+}
+
+void UMyCharacterMovementComponent::OnMovementUpdated(float DeltaSeconds, const FVector& OldLocation,
+	const FVector& OldVelocity)
+{
+	Super::OnMovementUpdated(DeltaSeconds, OldLocation, OldVelocity);
+
+	// Simulated proxies only follow the replicated movement, the abilities run on the owning client and the server
+	if (!CharacterOwner || CharacterOwner->GetLocalRole() == ROLE_SimulatedProxy)
+		return;
+	
+	if (GetPawnOwner()->GetLocalRole() > ROLE_SimulatedProxy)
+		RequestServerStateSync();
+
+	UpdateAbilitiesAfterMove(DeltaSeconds);
+}
+
+void UMyCharacterMovementComponent::UpdateAbilitiesAfterMove(float DeltaSeconds)
+{
+	if (bUseFixedTickSimulation)
+		AdvanceFixedTickAbilities(DeltaSeconds);
+
+	//Update dodge movement
+	if (bWantsToDodge && CanDodge)
+	{
+		CanDodge = false;
+		FVector DodgeVel = MoveDirection.GetSafeNormal() * GetTuning().BlinkStrength;
+		DodgeVel.Z = 0.0f;
+		
+		bWantsToDodge = false;
+		PushMovementModifier(MODIFIER_Dodge);
+		Launch(DodgeVel);
+		AddCosmeticEvent(EVENT_Blink);
+
+		if (bUseFixedTickSimulation)
+			DodgeTicksRemaining = static_cast<uint8>(FMath::Clamp(FMath::CeilToInt(GetTuning().BlinkDuration * FixedTickRate), 1, static_cast<int32>(MAX_uint8)));
+		else
+		{
+			FTimerHandle StoppingMovement;
+			GetWorld()->GetTimerManager().SetTimer(StoppingMovement, this, &UMyCharacterMovementComponent::EndDodge, GetTuning().BlinkDuration, false);
+		}
+	}
+
+	if (bWantsToSlideJump)
+	{
+		bWantsToSlideJump = false;
+		DoSlideJump();
+	}
+
+	// Only needed to mark the move it was fired in
+	bWantsToGrapple = false;
+
+	if (CurrentGrappleHookState == GRAPPLE_Attached)
+	{
+		if (GrappleHook)
+		{			
+			FVector Direction = (GrappleHook->GetActorLocation() - GetOwner()->GetActorLocation()).GetSafeNormal();
+
+			AddForce(Direction * GetTuning().GrapplePullForce);
+			
+			float DistanceFromHook = UKismetMathLibrary::Vector_Distance(GetOwner()->GetActorLocation(), GrappleHook->GetActorLocation());
+			if (DistanceFromHook < GetTuning().GrappleReleaseDistance)
+				GrappleHook->Destroy();
+			else if (UKismetMathLibrary::Dot_VectorVector(InitialHookDirection2D, Direction) < 0.f)
+				GrappleHook->Destroy();
+		}
+	}
+}
+
+void UMyCharacterMovementComponent::PhysCustom(float deltaTime, int32 Iterations)
+{
+	// Phys* functions should only run for characters with ROLE_Authority or ROLE_AutonomousProxy. However, Unreal calls PhysCustom in
+	// two separate locations, one of which doesn't check the role, so we must check it here to prevent this code from running on simulated proxies.
+	if (GetOwner()->GetLocalRole() == ROLE_SimulatedProxy)
+		return;
+
+	switch (CustomMovementMode)
+	{
+		case CMOVE_WallRunning:
+			{
+				PhysWallRunning(deltaTime, Iterations);
+				break;
+			}
+		default:
+			{
+				break;
+			}
+	}
+
+	// Not sure if this is needed
+	Super::PhysCustom(deltaTime, Iterations);
+}
+
+float UMyCharacterMovementComponent::GetMaxSpeed() const
+{
+	switch (MovementMode)
+	{
+	case MOVE_Walking:
+	case MOVE_NavWalking:
+		return GetTuning().GetMaxSpeed(GetSpeedState(), IsStimmy);
+	case MOVE_Falling:
+		return GetTuning().GetMaxSpeed(SPEED_Run, IsStimmy);
+	case MOVE_Swimming:
+		return MaxSwimSpeed;
+	case MOVE_Flying:
+		return MaxFlySpeed;
+	case MOVE_Custom:
+		return MaxCustomMovementSpeed;
+	case MOVE_None:
+	default:
+		return 0.f;
+	}
+}
+
+float UMyCharacterMovementComponent::GetMaxAcceleration() const
+{
+	if (IsMovingOnGround())
+		return GetTuning().GetMaxAcceleration(GetSpeedState(), IsStimmy);
+
+	return Super::GetMaxAcceleration();
+}
+
+EMovementSpeedState UMyCharacterMovementComponent::GetSpeedState() const
+{
+	if (bSpeedStateCached)
+	{
+		INC_DWORD_STAT(STAT_MyMovement_SpeedStateCacheHits);
+		return CachedSpeedState;
+	}
+
+	INC_DWORD_STAT(STAT_MyMovement_SpeedStateCacheMisses);
+
+	CachedSpeedState = CalcSpeedState();
+	bSpeedStateCached = bCacheSpeedState;
+	return CachedSpeedState;
+}
+
+EMovementSpeedState UMyCharacterMovementComponent::CalcSpeedState() const
+{
+	if (IsCustomMovementMode(CMOVE_WallRunning))
+		return SPEED_WallRun;
+	
+	if (IsCrouching())
+		return HasMovementModifier(MODIFIER_Slide) ? SPEED_Slide : SPEED_Crouch;
+
+	if (WantsToSprint && IsMovingForward())
+		return SPEED_Sprint;
+
+	return SPEED_Run;
+}
+
+void UMyCharacterMovementComponent::SimulateMovement(float DeltaTime)
+{
+	if (ProxyExtrapolationModel == EXTRAPOLATE_Default || !CharacterOwner || !UpdatedComponent)
+	{
+		ProxyExtrapolationTime = 0.f;
+		Super::SimulateMovement(DeltaTime);
+		return;
+	}
+
+	// A movement update arrived, start extrapolating again from the replicated location and velocity
+	if (bNetworkUpdateReceived)
+	{
+		bNetworkUpdateReceived = false;
+		ProxyExtrapolationTime = 0.f;
+
+		if (bNetworkMovementModeChanged)
+		{
+			ApplyNetworkMovementMode(CharacterOwner->GetReplicatedMovementMode());
+			bNetworkMovementModeChanged = false;
+		}
+	}
+
+	ExtrapolateProxy(DeltaTime);
+
+	UpdateComponentVelocity();
+	LastUpdateLocation = UpdatedComponent->GetComponentLocation();
+	LastUpdateRotation = UpdatedComponent->GetComponentQuat();
+	LastUpdateVelocity = Velocity;
+}
+
+void UMyCharacterMovementComponent::ProcessLanded(const FHitResult& Hit, float remainingTime, int32 Iterations)
+{
+	Super::ProcessLanded(Hit, remainingTime, Iterations);
+
+	// If we landed while wall running, make sure we stop wall running
+	if (IsCustomMovementMode(CMOVE_WallRunning))
+	{
+		EndWallRun();
+	}
+
+	PopMovementModifier(MODIFIER_SlideJump);
+}
+
+void UMyCharacterMovementComponent::CalcVelocity(float DeltaTime, float Friction, bool bFluid, float BrakingDeceleration)
+{
+	SCOPE_CYCLE_COUNTER(STAT_MyMovement_CalcVelocity);
+
+	// Every substep calculates its velocity once, the speed state can have changed since the last one
+	InvalidateSpeedState();
+
+	Super::CalcVelocity(DeltaTime, Friction, bFluid, BrakingDeceleration);
+}
+
+void UMyCharacterMovementComponent::UpdateCharacterStateBeforeMovement(float DeltaSeconds)
+{
+	Super::UpdateCharacterStateBeforeMovement(DeltaSeconds);
+
+	UpdateSlideState();
+	ApplyMovementModifiers();
+
+	// Crouching and the inputs of the move are only settled now
+	InvalidateSpeedState();
+}
+
+bool UMyCharacterMovementComponent::CanAttemptJump() const
+{
+	return IsJumpAllowed() && (IsMovingOnGround() || IsFalling());
+}
+
+void UMyCharacterMovementComponent::CallServerMovePacked(const FSavedMove_Character* NewMove, const FSavedMove_Character* PendingMove, const FSavedMove_Character* OldMove)
+{
+	if (NewMove)
+		TRACE_MOVEMENT_MOVE_SENT(*this, *NewMove);
+
+	INC_DWORD_STAT(STAT_MyMovement_ServerMovesSent);
+	if (OldMove)
+		INC_DWORD_STAT(STAT_MyMovement_ImportantMovesResent);
+	
+	Super::CallServerMovePacked(NewMove, PendingMove, OldMove);
+}
+
+void UMyCharacterMovementComponent::ControlledCharacterMove(const FVector& InputVector, float DeltaSeconds)
+{
+	// Set before the move is saved, so the saved move, the local move and the server all use the input of this frame
+	MoveDirection = FQuantizedMoveDirection::Quantize(InputVector);
+
+	Super::ControlledCharacterMove(InputVector, DeltaSeconds);
+}
+
+void UMyCharacterMovementComponent::ServerMove_PerformMovement(const FCharacterNetworkMoveData& MoveData)
+{
+	TRACE_MOVEMENT_SERVER_MOVE(*this, MoveData.TimeStamp);
+
+	// An old move newer than the last move performed means the packet that first carried it was lost
+	if (MoveData.NetworkMoveType == FCharacterNetworkMoveData::ENetworkMoveType::OldMove)
+	{
+		const FNetworkPredictionData_Server_Character* ServerData = GetPredictionData_Server_Character();
+		if (ServerData && MoveData.TimeStamp > ServerData->CurrentClientTimeStamp)
+			INC_DWORD_STAT(STAT_MyMovement_OldMovesRecovered);
+	}
+
+	if (bClientAuthoritativeMovement)
+	{
+		if (TryAcceptClientMove(MoveData))
+		{
+			INC_DWORD_STAT(STAT_MyMovement_ClientMovesAccepted);
+			return;
+		}
+		
+		INC_DWORD_STAT(STAT_MyMovement_ClientMovesOutsideEnvelope);
+
+		// The simulated move replaces whatever the accepted moves gained
+		FallingEnvelopeExcess = 0.f;
+	}
+	
+	Super::ServerMove_PerformMovement(MoveData);
 }
 
-void UMyCharacterMovementComponent::OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode)
+void UMyCharacterMovementComponent::ClientAckGoodMove_Implementation(float TimeStamp)
 {
-	if (PreviousMovementMode == MovementMode && PreviousCustomMode == CustomMovementMode)
-	{
-		Super::OnMovementModeChanged(PreviousMovementMode, PreviousCustomMode);
-		return;
-	}
+	TRACE_MOVEMENT_MOVE_ACKED(*this, TimeStamp);
 	
-#pragma region Leaving State Handlers
+	Super::ClientAckGoodMove_Implementation(TimeStamp);
+}
+
+bool UMyCharacterMovementComponent::ClientUpdatePositionAfterServerUpdate()
+{
+	SCOPE_CYCLE_COUNTER(STAT_MyMovement_CorrectionReplay);
 	
-	if (PreviousMovementMode == MOVE_Custom && PreviousCustomMode == CMOVE_WallRunning)
+	// The corrected move has already been acked at this point, everything left in SavedMoves is about to be replayed
+	if (FNetworkPredictionData_Client_Character* ClientData = GetPredictionData_Client_Character())
 	{
-		GravityScale = DefaultGravityScale; //in case slide jump to a wall
-		bConstrainToPlane = false;
+		if (ClientData->bUpdatePosition)
+		{
+#if MOVEMENTPREDICTION_TRACE_ENABLED
+			if (ClientData->LastAckedMove.IsValid())
+				TRACE_MOVEMENT_CORRECTION(*this, ClientData->LastAckedMove->TimeStamp, ClientData->SavedMoves.Num());
+#endif
+			if (ReplayCollapseThreshold > 0 && ClientData->SavedMoves.Num() > ReplayCollapseThreshold)
+			{
+				const int32 NumCollapsed = CollapseReplayMoves(*ClientData);
+				INC_DWORD_STAT_BY(STAT_MyMovement_ReplayMovesCollapsed, NumCollapsed);
+			}
+			
+			INC_DWORD_STAT_BY(STAT_MyMovement_CorrectionReplayDepth, ClientData->SavedMoves.Num());
+		}
 	}
+
+	// Replayed moves restore the modifiers and stimmy they were saved with, put back the live ones once the replay is done
+	const uint8 RealMovementModifiers = ActiveMovementModifiers;
+	const bool bRealIsStimmy = IsStimmy;
 	
+	const bool bResult = Super::ClientUpdatePositionAfterServerUpdate();
+
+	SetMovementModifiers(RealMovementModifiers);
+	IsStimmy = bRealIsStimmy;
+	return bResult;
+}
+
+void UMyCharacterMovementComponent::ClientHandleMoveResponse(const FCharacterMoveResponseDataContainer& MoveResponse)
+{
+	if (!MoveResponse.IsGoodMove())
+		INC_DWORD_STAT(STAT_MyMovement_CorrectionsReceived);
+
+	Super::ClientHandleMoveResponse(MoveResponse);
+}
+
 #pragma endregion
+
+#pragma region Client Authoritative Movement Functions
+
+float UMyCharacterMovementComponent::GetEnvelopeHorizontalSpeed() const
+{
+	float HorizontalSpeed = GetMaxSpeed();
+
+	if (IsCustomMovementMode(CMOVE_WallRunning))
+		HorizontalSpeed = FMath::Max(HorizontalSpeed, GetTuning().GetMaxSpeed(SPEED_WallRun, IsStimmy));
 	
-#pragma region Entering State Handlers
+	if (HasMovementModifier(MODIFIER_Slide))
+		HorizontalSpeed = FMath::Max(HorizontalSpeed, GetTuning().MaxSlideSpeed);
+	
+	// Only abilities the server has started widen the envelope, the input flags alone are up to the client
+	if (HasMovementModifier(MODIFIER_Dodge))
+		HorizontalSpeed = FMath::Max(HorizontalSpeed, GetTuning().BlinkStrength);
+	
+	if (HasMovementModifier(MODIFIER_SlideJump))
+		HorizontalSpeed = FMath::Max(HorizontalSpeed, GetTuning().MaxSlideSpeed + GetTuning().HorizontalSlideJumpForce);
 
-	if (MovementMode == MOVE_Walking || MovementMode == MOVE_NavWalking)
+	// Falling characters keep the momentum of the moves before, air control can't add to it
+	if (IsFalling())
+		HorizontalSpeed = FMath::Max(HorizontalSpeed, static_cast<float>(Velocity.Size2D()));
+
+	return HorizontalSpeed;
+}
+
+float UMyCharacterMovementComponent::GetFallingMoveStartVelocityZ() const
+{
+	float StartVelocityZ = static_cast<float>(Velocity.Z);
+
+	// A blink launches level
+	if (HasMovementModifier(MODIFIER_Dodge))
+		StartVelocityZ = FMath::Max(StartVelocityZ, 0.f);
+
+	return StartVelocityZ;
+}
+
+bool UMyCharacterMovementComponent::IsInsideMoveEnvelope(const FVector& Displacement, float DeltaTime) const
+{
+	const float MaxTime = DeltaTime * MoveEnvelopeTolerance;
+	if (Displacement.Size2D() > GetEnvelopeHorizontalSpeed() * MaxTime + MoveEnvelopeSlack)
+		return false;
+
+	if (IsFalling())
 	{
-		SetImpulseMovementMode(CMOVE_Grounded);
+		// A falling character rises no higher than its start velocity allows under gravity. The slack is shared by the
+		// whole fall through FallingEnvelopeExcess, otherwise it could be gained again on every move to climb.
+		const float BallisticRise = GetFallingMoveStartVelocityZ() * DeltaTime + 0.5f * GetGravityZ() * FMath::Square(DeltaTime);
+		return FallingEnvelopeExcess + Displacement.Z - BallisticRise <= MoveEnvelopeSlack &&
+			-Displacement.Z <= GetPhysicsVolume()->TerminalVelocity * MaxTime + MoveEnvelopeSlack;
 	}
-	if (MovementMode == MOVE_Falling)
+
+	// Walkable slopes move the character up and down about as fast as it moves along them
+	const float VerticalSpeed = GetMaxSpeed();
+	return FMath::Abs(Displacement.Z) <= VerticalSpeed * MaxTime + MaxStepHeight + MoveEnvelopeSlack;
+}
+
+bool UMyCharacterMovementComponent::TryAcceptClientMove(const FCharacterNetworkMoveData& MoveData)
+{
+	FNetworkPredictionData_Server_Character* ServerData = GetPredictionData_Server_Character();
+	if (!ServerData || !CharacterOwner || !UpdatedComponent || ServerData->bForceClientUpdate)
+		return false;
+
+	// The location of based moves is relative to the base, leave those to the full simulation
+	if (MoveData.MovementBase)
+		return false;
+
+	bool bTimeStampResetDetected = false;
+	if (!IsClientTimeStampValid(MoveData.TimeStamp, *ServerData, bTimeStampResetDetected) || bTimeStampResetDetected)
+		return false;
+
+	// Mode changes start jumps, wall runs and falls the envelope can't follow, and the grapple pull has no fixed limit
+	if (MoveData.MovementMode != PackNetworkMovementMode() || CurrentGrappleHookState == GRAPPLE_Attached)
+		return false;
+
+	const float DeltaTime = ServerData->GetServerMoveDeltaTime(MoveData.TimeStamp, CharacterOwner->GetActorTimeDilation());
+	if (DeltaTime <= 0.f)
+		return false;
+
+	UpdateFromCompressedFlags(MoveData.CompressedMoveFlags);
+
+	// Jumps count towards JumpMaxCount, which only the simulation keeps track of
+	if (CharacterOwner->bPressedJump && CharacterOwner->CanJump())
+		return false;
+
+	const FVector Displacement = MoveData.Location - UpdatedComponent->GetComponentLocation();
+	if (!IsInsideMoveEnvelope(Displacement, DeltaTime))
+		return false;
+
+	// Read before the move changes the state the envelope was built from
+	const bool bFalling = IsFalling();
+	const float MaxHorizontalSpeed = GetEnvelopeHorizontalSpeed();
+	const float StartVelocityZ = bFalling ? GetFallingMoveStartVelocityZ() : 0.f;
+
+	// The same time stamp bookkeeping ServerMove_PerformMovement does for a simulated move
+	ServerData->CurrentClientTimeStamp = MoveData.TimeStamp;
+	ServerData->ServerAccumulatedClientTimeStamp += DeltaTime;
+	ServerData->ServerTimeStamp = GetWorld()->GetTimeSeconds();
+	ServerData->ServerTimeStampLastServerMove = ServerData->ServerTimeStamp;
+
+	if (APlayerController* PC = Cast<APlayerController>(CharacterOwner->GetController()))
 	{
-		SetImpulseMovementMode(CMOVE_InAir);
+		PC->SetControlRotation(MoveData.ControlRotation);
+		PC->UpdateRotation(DeltaTime);
 	}
-	
-	if (IsCustomMovementMode(CMOVE_WallRunning))
+
+	UpdatedComponent->SetWorldLocation(MoveData.Location);
+	Velocity = Displacement / DeltaTime;
+
+	if (bFalling)
 	{
-		SetImpulseMovementMode(CMOVE_WallRunning);
-		StopMovementImmediately();
-		bConstrainToPlane = true;
-		SetPlaneConstraintNormal(FVector(0.0f, 0.0f, 1.0f));
+		// The velocity the next envelope starts from is kept inside this one, so the tolerance and slack can't build up from move to move
+		const float GravityZ = GetGravityZ();
+		const float BallisticRise = StartVelocityZ * DeltaTime + 0.5f * GravityZ * FMath::Square(DeltaTime);
+		FallingEnvelopeExcess = FMath::Max(FallingEnvelopeExcess + Displacement.Z - BallisticRise, 0.f);
+
+		Velocity = Velocity.GetClampedToMaxSize2D(MaxHorizontalSpeed);
+		Velocity.Z = FMath::Min(Velocity.Z + 0.5f * GravityZ * DeltaTime, static_cast<double>(StartVelocityZ + GravityZ * DeltaTime));
 	}
+	else
+		FallingEnvelopeExcess = 0.f;
+	
+	UpdateComponentVelocity();
+	UpdateSlideState();
 
-#pragma endregion 
+	// Start the blink and slide jump like a simulated move would. The client's location already
+	// includes the launches, so the forces they queue must not be applied on top of it.
+	UpdateAbilitiesAfterMove(DeltaTime);
+	ClearAccumulatedForces();
 
-	Super::OnMovementModeChanged(PreviousMovementMode, PreviousCustomMode);
-	
+	LastUpdateLocation = UpdatedComponent->GetComponentLocation();
+	LastUpdateRotation = UpdatedComponent->GetComponentQuat();
+	LastUpdateVelocity = Velocity;
+
+	ServerData->PendingAdjustment.TimeStamp = MoveData.TimeStamp;
+	ServerData->PendingAdjustment.bAckGoodMove = true;
+	return true;
 }
 
-void UMyCharacterMovementComponent::OnMovementUpdated(float DeltaSeconds, const FVector& OldLocation,
-	const FVector& OldVelocity)
+#pragma endregion
+
+#pragma region Correction Replay Functions
+
+int32 UMyCharacterMovementComponent::CollapseReplayMoves(FNetworkPredictionData_Client_Character& ClientData)
 {
-	Super::OnMovementUpdated(DeltaSeconds, OldLocation, OldVelocity);
+	TArray<FSavedMovePtr>& SavedMoves = ClientData.SavedMoves;
+	const int32 NumSavedMoves = SavedMoves.Num();
 
-	if (!CharacterOwner)
-		return;
-	
-	if (PawnOwner->IsLocallyControlled())
-		MoveDirection = PawnOwner->GetLastMovementInputVector();
-	
-	if (GetPawnOwner()->GetLocalRole() > ROLE_SimulatedProxy)
-		ServerSetMoveDirection(MoveDirection);
+	// The pending move is the last saved move. The next move is combined with it by reverting to its start location,
+	// so it has to keep its own delta time or the collapsed time would be simulated a second time.
+	int32 NumMoves = NumSavedMoves;
+	if (NumMoves > 0 && ClientData.PendingMove.IsValid() && SavedMoves.Last() == ClientData.PendingMove)
+		NumMoves--;
 
-	//Update dodge movement
-	if (bWantsToDodge && CanDodge)
-	{
-		CanDodge = false;
-		MoveDirection.Normalize();
-		FVector DodgeVel = MoveDirection * BlinkStrength;
-		DodgeVel.Z = 0.0f;
-		
-		bWantsToDodge = false;
-		GroundFriction = 0.f;
-		Launch(DodgeVel);
-		FTimerHandle StoppingMovement;
-		GetWorld()->GetTimerManager().SetTimer(StoppingMovement, this, &UMyCharacterMovementComponent::EndDodge, BlinkDuration, false);
-	}
+	if (NumMoves < 2)
+		return 0;
 
-	if (CurrentGrappleHookState == GRAPPLE_Attached)
-	{
-		if (GrappleHook)
-		{			
-			FVector Direction = (GrappleHook->GetActorLocation() - GetOwner()->GetActorLocation()).GetSafeNormal();
+	const float MaxDelta = ClientData.MaxMoveDeltaTime * CharacterOwner->GetActorTimeDilation();
 
-			AddForce(Direction * GrapplePullForce);
-			
-			float DistanceFromHook = UKismetMathLibrary::Vector_Distance(GetOwner()->GetActorLocation(), GrappleHook->GetActorLocation());
-			if (DistanceFromHook < 250.f)
-				GrappleHook->Destroy();
-			else if (UKismetMathLibrary::Dot_VectorVector(InitialHookDirection2D, Direction) < 0.f)
-				GrappleHook->Destroy();
+	// Fold each move into the next one while they can be combined, the later move keeps its time stamp
+	int32 LastIndex = 0;
+	for (int32 i = 1; i < NumMoves; i++)
+	{
+		FSavedMovePtr& LastMove = SavedMoves[LastIndex];
+		if (LastMove->CanCombineWith(SavedMoves[i], CharacterOwner, MaxDelta))
+		{
+			SavedMoves[i]->DeltaTime += LastMove->DeltaTime;
+			static_cast<FSavedMove_MyMovement*>(SavedMoves[i].Get())->TakeFixedTicksFrom(*static_cast<const FSavedMove_MyMovement*>(LastMove.Get()));
+			ClientData.FreeMove(LastMove);
+			LastMove = SavedMoves[i];
+		}
+		else
+		{
+			SavedMoves[++LastIndex] = SavedMoves[i];
 		}
 	}
+
+	for (int32 i = NumMoves; i < NumSavedMoves; i++)
+		SavedMoves[++LastIndex] = SavedMoves[i];
+
+	SavedMoves.SetNum(LastIndex + 1);
+	return NumSavedMoves - SavedMoves.Num();
 }
 
-void UMyCharacterMovementComponent::PhysCustom(float deltaTime, int32 Iterations)
+#pragma endregion
+
+#pragma region Server State Functions
+
+FMovementStateDelta UMyCharacterMovementComponent::MakeServerState() const
 {
-	// Phys* functions should only run for characters with ROLE_Authority or ROLE_AutonomousProxy. However, Unreal calls PhysCustom in
-	// two separate locations, one of which doesn't check the role, so we must check it here to prevent this code from running on simulated proxies.
-	if (GetOwner()->GetLocalRole() == ROLE_SimulatedProxy)
-		return;
+	FMovementStateDelta State;
+	State.DirtyMask = STATE_All;
+	State.WallRunSide = WallRunSide;
+	State.ImpulseMovementMode = ImpulseMovementMode;
+	State.GrappleHookState = CurrentGrappleHookState;
+	State.IsStimmy = IsStimmy;
+	State.MoveDirection = MoveDirection;
+	return State;
+}
 
-	switch (CustomMovementMode)
+void UMyCharacterMovementComponent::FlushServerState()
+{
+	FMovementStateDelta Delta = MakeServerState();
+	Delta.DirtyMask = 0;
+
+	if (Delta.WallRunSide != LastServerState.WallRunSide)
+		Delta.DirtyMask |= STATE_WallRunSide;
+	if (Delta.ImpulseMovementMode != LastServerState.ImpulseMovementMode)
+		Delta.DirtyMask |= STATE_ImpulseMovementMode;
+	if (Delta.GrappleHookState != LastServerState.GrappleHookState)
+		Delta.DirtyMask |= STATE_GrappleHookState;
+	if (Delta.IsStimmy != LastServerState.IsStimmy)
+		Delta.DirtyMask |= STATE_Stimmy;
+	// Small changes are below the precision the direction is sent with, the moves carry it when the packed state is used
+	if (!bUsePackedMovementState && !Delta.MoveDirection.Equals(LastServerState.MoveDirection, 0.01f))
+		Delta.DirtyMask |= STATE_MoveDirection;
+
+	const int32 SentRPCs = Delta.DirtyMask != 0 ? 1 : 0;
+	const int32 SuppressedRPCs = FMath::Max(PendingServerStateRequests - SentRPCs, 0);
+	PendingServerStateRequests = 0;
+
+	// Only the locally controlled character sends anything over the network, the server flushing for a remote player is a local call
+	if (GetPawnOwner()->IsLocallyControlled())
 	{
-		case CMOVE_WallRunning:
-			{
-				PhysWallRunning(deltaTime, Iterations);
-				break;
-			}
-		default:
-			{
-				break;
-			}
+		SuppressedServerStateRPCs += SuppressedRPCs;
+		INC_DWORD_STAT_BY(STAT_MyMovement_StateRPCsSuppressed, SuppressedRPCs);
 	}
 
-	// Not sure if this is needed
-	Super::PhysCustom(deltaTime, Iterations);
+	if (SentRPCs == 0)
+		return;
+
+	LastServerState = Delta;
+	LastServerState.DirtyMask = STATE_All;
+
+	INC_DWORD_STAT(STAT_MyMovement_StateRPCsSent);
+	ServerSetMovementState(Delta);
 }
 
-float UMyCharacterMovementComponent::GetMaxSpeed() const
+void UMyCharacterMovementComponent::ServerSetMovementState_Implementation(const FMovementStateDelta& Delta)
 {
-	switch (MovementMode)
+	// Remember what the client sent so the server never echoes the same values back out through its own flush
+	if (Delta.DirtyMask & STATE_WallRunSide)
 	{
-	case MOVE_Walking:
-	case MOVE_NavWalking:
+		LastServerState.WallRunSide = Delta.WallRunSide;
+		SetReplicatedWallRunSide(static_cast<EWallRunSide>(Delta.WallRunSide));
+	}
+	if (Delta.DirtyMask & STATE_ImpulseMovementMode)
 	{
-		if (IsCrouching())
-		{
-			return MaxWalkSpeedCrouched;
-		}
-			
-		if (WantsToSprint && IsMovingForward())
-		{
-			return CurrentMaxSprintSpeed;
-		}
-			
-		return CurrentMaxRunSpeed;
+		LastServerState.ImpulseMovementMode = Delta.ImpulseMovementMode;
+		SetReplicatedImpulseMovementMode(static_cast<EImpulseMovementMode>(Delta.ImpulseMovementMode));
 	}
-	case MOVE_Falling:
-		return CurrentMaxRunSpeed;
-	case MOVE_Swimming:
-		return MaxSwimSpeed;
-	case MOVE_Flying:
-		return MaxFlySpeed;
-	case MOVE_Custom:
-		return MaxCustomMovementSpeed;
-	case MOVE_None:
-	default:
-		return 0.f;
+	if (Delta.DirtyMask & STATE_GrappleHookState)
+	{
+		LastServerState.GrappleHookState = Delta.GrappleHookState;
+		CurrentGrappleHookState = static_cast<EGrappleHookState>(Delta.GrappleHookState);
+	}
+	if (Delta.DirtyMask & STATE_Stimmy)
+	{
+		LastServerState.IsStimmy = Delta.IsStimmy;
+		IsStimmy = Delta.IsStimmy;
+	}
+	if (Delta.DirtyMask & STATE_MoveDirection)
+	{
+		LastServerState.MoveDirection = Delta.MoveDirection;
+		MoveDirection = Delta.MoveDirection;
 	}
 }
 
-float UMyCharacterMovementComponent::GetMaxAcceleration() const
+bool UMyCharacterMovementComponent::ServerSetMovementState_Validate(const FMovementStateDelta& Delta)
 {
-	if (IsMovingOnGround())
-	{
-		if (WantsToSprint && IsMovingForward())
-		{
-			return DefaultMaxSprintAcceleration;
-		}
+	return true;
+}
 
-		return CurrentMaxRunAcceleration;
-	}
+#pragma endregion 
 
-	return Super::GetMaxAcceleration();
-}
+#pragma endregion
 
-void UMyCharacterMovementComponent::ProcessLanded(const FHitResult& Hit, float remainingTime, int32 Iterations)
+#pragma region struct FMovementStateDelta
+
+bool FMovementStateDelta::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
 {
-	Super::ProcessLanded(Hit, remainingTime, Iterations);
+	bOutSuccess = true;
 
-	// If we landed while wall running, make sure we stop wall running
-	if (IsCustomMovementMode(CMOVE_WallRunning))
+	Ar.SerializeBits(&DirtyMask, 5);
+
+	if (DirtyMask & STATE_WallRunSide)
+		Ar << WallRunSide;
+	if (DirtyMask & STATE_ImpulseMovementMode)
+		Ar << ImpulseMovementMode;
+	if (DirtyMask & STATE_GrappleHookState)
+		Ar << GrappleHookState;
+	if (DirtyMask & STATE_Stimmy)
 	{
-		EndWallRun();
+		uint8 bValue = IsStimmy;
+		Ar.SerializeBits(&bValue, 1);
+		IsStimmy = bValue != 0;
+	}
+	if (DirtyMask & STATE_MoveDirection)
+	{
+		FQuantizedMoveDirection Packed = FQuantizedMoveDirection::Pack(MoveDirection);
+		Ar << Packed.X;
+		Ar << Packed.Y;
+		MoveDirection = Packed.Unpack();
 	}
 
-	GravityScale = DefaultGravityScale;
+	return true;
 }
 
-bool UMyCharacterMovementComponent::CanAttemptJump() const
+#pragma endregion
+
+#pragma region struct FMyMovementNetState
+
+bool FMyMovementNetState::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
 {
-	return IsJumpAllowed() && (IsMovingOnGround() || IsFalling());
+	bOutSuccess = true;
+
+	// 3 bits of extrapolation model, 1 bit of sliding and 2 bits of wall run side
+	uint8 Packed = (ProxyExtrapolationModel & 0x07) | (IsSliding ? 0x08 : 0) | ((WallRunSide & 0x03) << 4);
+	Ar.SerializeBits(&Packed, 6);
+	ProxyExtrapolationModel = Packed & 0x07;
+	IsSliding = (Packed & 0x08) != 0;
+	WallRunSide = (Packed >> 4) & 0x03;
+
+	Ar << ImpulseMovementMode;
+
+	if (UsesExtrapolationDirection())
+		bOutSuccess &= SerializeFixedVector<1, 16>(ProxyExtrapolationDirection, Ar);
+	if (UsesExtrapolationAnchor())
+		bOutSuccess &= SerializePackedVector<1, 24>(ProxyExtrapolationAnchor, Ar);
+
+	return true;
+}
+
+bool FMyMovementNetState::operator==(const FMyMovementNetState& Other) const
+{
+	return WallRunSide == Other.WallRunSide
+		&& ImpulseMovementMode == Other.ImpulseMovementMode
+		&& ProxyExtrapolationModel == Other.ProxyExtrapolationModel
+		&& IsSliding == Other.IsSliding
+		&& ProxyExtrapolationDirection.Equals(Other.ProxyExtrapolationDirection, 0.001f)
+		&& ProxyExtrapolationAnchor.Equals(Other.ProxyExtrapolationAnchor, 0.5f);
 }
 
 #pragma endregion
 
-#pragma region Compressed Flag Functions
+#pragma region struct FMyCharacterNetworkMoveData
 
-void UMyCharacterMovementComponent::ServerSetMoveDirection_Implementation(const FVector& MoveDir)
+void FMyCharacterNetworkMoveData::ClientFillNetworkMoveData(const FSavedMove_Character& ClientMove, ENetworkMoveType MoveType)
 {
-	MoveDirection = MoveDir;
+	Super::ClientFillNetworkMoveData(ClientMove, MoveType);
+
+	MoveDirection = static_cast<const FSavedMove_MyMovement&>(ClientMove).GetSavedState().MoveDirection.Unpack();
 }
 
-bool UMyCharacterMovementComponent::ServerSetMoveDirection_Validate(const FVector& MoveDir)
+bool FMyCharacterNetworkMoveData::Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType)
 {
-	return true;
+	Super::Serialize(CharacterMovement, Ar, PackageMap, MoveType);
+
+	// Most moves have no direction at all, which costs a single bit
+	uint8 bHasDirection = !MoveDirection.IsNearlyZero();
+	Ar.SerializeBits(&bHasDirection, 1);
+
+	if (bHasDirection)
+	{
+		// The same quantization the direction is produced with, so nothing is lost on the way
+		FQuantizedMoveDirection Packed = FQuantizedMoveDirection::Pack(MoveDirection);
+		Ar << Packed.X;
+		Ar << Packed.Y;
+
+		MoveDirection = Packed.Unpack();
+	}
+	else
+		MoveDirection = FVector::ZeroVector;
+
+	return !Ar.IsError();
 }
 
-#pragma endregion 
+FMyCharacterNetworkMoveDataContainer::FMyCharacterNetworkMoveDataContainer()
+{
+	NewMoveData = &MoveData[0];
+	PendingMoveData = &MoveData[1];
+	OldMoveData = &MoveData[2];
+}
 
 #pragma endregion
 
@@ -1131,10 +2428,7 @@ bool UMyCharacterMovementComponent::ServerSetMoveDirection_Validate(const FVecto
 
 FSavedMove_MyMovement::FSavedMove_MyMovement()
 {
-	SavedWantsToSprint = false;
-	SavedWallRunKeysDown = false;
-	bSavedWantsToDodge = false;
-	SavedMoveDirection = FVector::ZeroVector;
+	FMemory::Memzero(SavedState);
 }
 
 #pragma region Saved Move Overrides
@@ -1144,30 +2438,35 @@ void FSavedMove_MyMovement::Clear()
 	Super::Clear();
 
 	// Clear all values
-	SavedWantsToSprint = false;
-	SavedWallRunKeysDown = false;
-	bSavedWantsToDodge = false;
-	SavedMoveDirection = FVector::ZeroVector;
+	FMemory::Memzero(SavedState);
 }
 
 uint8 FSavedMove_MyMovement::GetCompressedFlags() const
 {
 	uint8 Result = Super::GetCompressedFlags();
 
-	/* There are 4 custom move flags for us to use. Below is what each is currently being used for:
-	FLAG_Custom_0		= 0x10, // Sprinting
-	FLAG_Custom_1		= 0x20, // WallRunning
-	FLAG_Custom_2		= 0x40, // Blinking
-	FLAG_Custom_3		= 0x80, // Unused
+	/* Below is what each of the move flags we use is currently being used for:
+	FLAG_Reserved_1		= 0x04, // Sprinting
+	FLAG_Reserved_2		= 0x08, // WallRunning
+	FLAG_Custom_0		= 0x10, // Sliding
+	FLAG_Custom_1		= 0x20, // Blinking
+	FLAG_Custom_2		= 0x40, // SlideJumping
+	FLAG_Custom_3		= 0x80, // Grappling
 	*/
 	
 	// Write to the compressed flags 
-	if (SavedWantsToSprint)
+	if (SavedState.WantsToSprint)
 		Result |= FLAG_Sprint;
-	if (SavedWallRunKeysDown)
+	if (SavedState.WallRunKeysDown)
 		Result |= FLAG_WallRun;
-	if (bSavedWantsToDodge)
+	if (SavedState.bWantsToSlide)
+		Result |= FLAG_Slide;
+	if (SavedState.bWantsToDodge)
 		Result |= FLAG_3;
+	if (SavedState.bWantsToSlideJump)
+		Result |= FLAG_SlideJump;
+	if (SavedState.bWantsToGrapple)
+		Result |= FLAG_Grapple;
 
 	return Result;
 }
@@ -1177,17 +2476,35 @@ bool FSavedMove_MyMovement::CanCombineWith(const FSavedMovePtr& NewMovePtr, ACha
 	const FSavedMove_MyMovement* NewMove = static_cast<const FSavedMove_MyMovement*>(NewMovePtr.Get());
 
 	// As an optimization, check if the engine can combine saved moves.
-	if (SavedWantsToSprint != NewMove->SavedWantsToSprint ||
-		SavedWallRunKeysDown != NewMove->SavedWallRunKeysDown ||
-		bSavedWantsToDodge != NewMove->bSavedWantsToDodge ||
-		SavedMoveDirection != NewMove->SavedMoveDirection)
-	{
+	if (!SavedState.EqualsIgnoringFixedTicks(NewMove->SavedState))
 		return false;
-	}
 
 	return Super::CanCombineWith(NewMovePtr, Character, MaxDelta);
 }
 
+void FSavedMove_MyMovement::CombineWith(const FSavedMove_Character* OldMove, ACharacter* InCharacter, APlayerController* PC, const FVector& OldStartLocation)
+{
+	// CanCombineWith is only a query, the engine can still decide not to combine after it
+	INC_DWORD_STAT(STAT_MyMovement_SavedMovesCombined);
+
+	Super::CombineWith(OldMove, InCharacter, PC, OldStartLocation);
+
+	// The combined move is simulated again from the start of the old move, roll the fixed tick counters back with it
+	// the same way the engine rolls back the jump state
+	TakeFixedTicksFrom(*static_cast<const FSavedMove_MyMovement*>(OldMove));
+	if (UMyCharacterMovementComponent* CharMov = Cast<UMyCharacterMovementComponent>(InCharacter->GetCharacterMovement()))
+	{
+		CharMov->DodgeTicksRemaining = SavedState.DodgeTicksRemaining;
+		CharMov->SlideForceTicks = SavedState.SlideForceTicks;
+	}
+}
+
+void FSavedMove_MyMovement::TakeFixedTicksFrom(const FSavedMove_MyMovement& EarlierMove)
+{
+	SavedState.DodgeTicksRemaining = EarlierMove.SavedState.DodgeTicksRemaining;
+	SavedState.SlideForceTicks = EarlierMove.SavedState.SlideForceTicks;
+}
+
 void FSavedMove_MyMovement::SetMoveFor(ACharacter* Character, float InDeltaTime, FVector const& NewAccel, class FNetworkPredictionData_Client_Character& ClientData)
 {
 	Super::SetMoveFor(Character, InDeltaTime, NewAccel, ClientData);
@@ -1195,10 +2512,18 @@ void FSavedMove_MyMovement::SetMoveFor(ACharacter* Character, float InDeltaTime,
 	if (const UMyCharacterMovementComponent* CharMov = static_cast<UMyCharacterMovementComponent*>(Character->GetCharacterMovement()))
 	{
 		// Copy values into the saved move
-		SavedWantsToSprint = CharMov->WantsToSprint;
-		SavedWallRunKeysDown = CharMov->WallRunKeysDown;
-		bSavedWantsToDodge = CharMov->bWantsToDodge;
-		SavedMoveDirection = CharMov->MoveDirection;
+		FMemory::Memzero(SavedState);
+		SavedState.WantsToSprint = CharMov->WantsToSprint;
+		SavedState.WallRunKeysDown = CharMov->WallRunKeysDown;
+		SavedState.bWantsToDodge = CharMov->bWantsToDodge;
+		SavedState.bWantsToSlide = CharMov->bWantsToSlide;
+		SavedState.bWantsToSlideJump = CharMov->bWantsToSlideJump;
+		SavedState.bWantsToGrapple = CharMov->bWantsToGrapple;
+		SavedState.MoveDirection = FQuantizedMoveDirection::Pack(CharMov->MoveDirection);
+		SavedState.bIsStimmy = CharMov->IsStimmy;
+		SavedState.MovementModifiers = CharMov->ActiveMovementModifiers;
+		SavedState.DodgeTicksRemaining = CharMov->DodgeTicksRemaining;
+		SavedState.SlideForceTicks = CharMov->SlideForceTicks;
 	}
 }
 
@@ -1209,10 +2534,17 @@ void FSavedMove_MyMovement::PrepMoveFor(class ACharacter* Character)
 	if (UMyCharacterMovementComponent* CharMov = Cast<UMyCharacterMovementComponent>(Character->GetCharacterMovement()))
 	{
 		// Copy values out of the saved move
-		CharMov->WantsToSprint = SavedWantsToSprint;
-		CharMov->WallRunKeysDown = SavedWallRunKeysDown;
-		CharMov->bWantsToDodge = bSavedWantsToDodge;
-		CharMov->MoveDirection = SavedMoveDirection;
+		CharMov->WantsToSprint = SavedState.WantsToSprint;
+		CharMov->WallRunKeysDown = SavedState.WallRunKeysDown;
+		CharMov->bWantsToDodge = SavedState.bWantsToDodge;
+		CharMov->bWantsToSlide = SavedState.bWantsToSlide;
+		CharMov->bWantsToSlideJump = SavedState.bWantsToSlideJump;
+		CharMov->bWantsToGrapple = SavedState.bWantsToGrapple;
+		CharMov->MoveDirection = SavedState.MoveDirection.Unpack();
+		CharMov->IsStimmy = SavedState.bIsStimmy;
+		CharMov->SetMovementModifiers(SavedState.MovementModifiers);
+		CharMov->DodgeTicksRemaining = SavedState.DodgeTicksRemaining;
+		CharMov->SlideForceTicks = SavedState.SlideForceTicks;
 	}
 }
 
@@ -1227,12 +2559,54 @@ void FSavedMove_MyMovement::PrepMoveFor(class ACharacter* Character)
 FNetworkPredictionData_Client_My::FNetworkPredictionData_Client_My(const UCharacterMovementComponent& ClientMovement)
 	: Super(ClientMovement)
 {
+	// The engine only allocates while there are fewer than MaxSavedMoveCount saved moves, plus the pending and last acked moves
+	const int32 PoolSize = MaxSavedMoveCount + 2;
+	
+	SavedMovePool.Reserve(PoolSize);
+	for (int32 i = 0; i < PoolSize; i++)
+		SavedMovePool.Add(MakeShared<FSavedMove_MyMovement>());
+
+	// Every client has a pool of the same size, the total is the sum over all the clients in this process
+	INC_MEMORY_STAT_BY(STAT_MyMovement_SavedMovePoolMemory, GetSavedMovePoolSize());
+	SET_MEMORY_STAT(STAT_MyMovement_SavedMovePoolMemoryPerClient, GetSavedMovePoolSize());
+}
 
+FNetworkPredictionData_Client_My::~FNetworkPredictionData_Client_My()
+{
+	DEC_MEMORY_STAT_BY(STAT_MyMovement_SavedMovePoolMemory, GetSavedMovePoolSize());
 }
 
 FSavedMovePtr FNetworkPredictionData_Client_My::AllocateNewMove()
 {
-	return FSavedMovePtr(new FSavedMove_MyMovement());
+	// A pooled move is free when the pool holds the only reference to it. Moves in the engine's FreeMoves are still
+	// referenced from there, the engine hands those out itself and only asks for a new move once FreeMoves is empty.
+	FSavedMovePtr FreeMove;
+	for (const FSavedMovePtr& PooledMove : SavedMovePool)
+	{
+		if (PooledMove.IsUnique())
+		{
+			FreeMove = PooledMove;
+			break;
+		}
+	}
+
+	// The pending move is always one of the saved moves, the last acked move is kept out of them
+	const int32 NumInUse = SavedMoves.Num() + (LastAckedMove.IsValid() ? 1 : 0) + 1;
+	if (NumInUse > PeakSavedMovesInUse)
+	{
+		PeakSavedMovesInUse = NumInUse;
+		SET_DWORD_STAT(STAT_MyMovement_SavedMovePoolPeakInUse, PeakSavedMovesInUse);
+	}
+
+	if (!FreeMove.IsValid())
+	{
+		INC_DWORD_STAT(STAT_MyMovement_SavedMovePoolExhausted);
+		return FSavedMovePtr(new FSavedMove_MyMovement());
+	}
+
+	// Moves dropped by the engine without going through its free list were never cleared
+	FreeMove->Clear();
+	return FreeMove;
 }
 
 #pragma endregion
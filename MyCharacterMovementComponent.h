@@ -2,15 +2,242 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "Character/Components/MovementPredictionTrace.h"
+#include "Character/Components/MyMovementTuning.h"
 #include "MyCharacterMovementComponent.generated.h"
 
+DECLARE_STATS_GROUP(TEXT("My Character Movement"), STATGROUP_MyCharacterMovement, STATCAT_Advanced);
+
 class AGrappleHook;
 class AGrappleHookCable;
 class AImpulseDefaultCharacter;
+class UMyMovementTuning;
+class UCameraModifier;
+class UMovementCameraModifier;
 enum EGrappleHookState;
 enum EWallRunSide;
 enum EImpulseMovementMode;
 
+/**
+ *	Abilities that temporarily override the physics values of the character, ordered from the highest priority to the lowest.
+ *	When more than one active modifier overrides the same value, the one with the highest priority wins.
+ *	MODIFIER_Grapple - no ground friction and no gravity while being pulled by the grapple hook.
+ *	MODIFIER_SlideJump - increased gravity until landing after a slide jump.
+ *	MODIFIER_Dodge - no ground friction for the duration of the blink.
+ *	MODIFIER_Slide - no ground friction and the slide speed while sliding.
+ */
+enum EMovementModifier : uint8
+{
+	MODIFIER_Grapple,
+	MODIFIER_SlideJump,
+	MODIFIER_Dodge,
+	MODIFIER_Slide,
+	MODIFIER_MAX
+};
+
+/**
+ *	The dead reckoning model simulated proxies use between movement updates.
+ *	EXTRAPOLATE_Default - the default character movement simulation.
+ *	EXTRAPOLATE_WallRun - linear along the wall run direction.
+ *	EXTRAPOLATE_Grapple - pulled towards the grapple hook anchor.
+ *	EXTRAPOLATE_Slide - accelerated down the slope of the floor.
+ *	EXTRAPOLATE_SlideJump - ballistic using the slide jump gravity.
+ */
+enum EProxyExtrapolationModel : uint8
+{
+	EXTRAPOLATE_Default,
+	EXTRAPOLATE_WallRun,
+	EXTRAPOLATE_Grapple,
+	EXTRAPOLATE_Slide,
+	EXTRAPOLATE_SlideJump
+};
+
+/**
+ *	The fields of FMovementStateDelta, used as the bits of its dirty mask.
+ *	STATE_WallRunSide - the side of the player that is on the wall.
+ *	STATE_ImpulseMovementMode - the movement mode used by the animations.
+ *	STATE_Stimmy - whether the stimmy is active.
+ *	STATE_GrappleHookState - the state of the grapple hook.
+ *	STATE_MoveDirection - the movement input direction of the player.
+ */
+enum EMovementStateField : uint8
+{
+	STATE_WallRunSide = 1 << 0,
+	STATE_ImpulseMovementMode = 1 << 1,
+	STATE_Stimmy = 1 << 2,
+	STATE_GrappleHookState = 1 << 3,
+	STATE_MoveDirection = 1 << 4,
+	STATE_All = (1 << 5) - 1
+};
+
+/**
+ *	A horizontal movement direction quantized to 16 bits per component. The direction is quantized where it is produced,
+ *	so the live move, the saved move, the replays and the server all use the same value.
+ */
+struct FQuantizedMoveDirection
+{
+	int16 X;
+	int16 Y;
+
+	static FQuantizedMoveDirection Pack(const FVector& Direction)
+	{
+		FQuantizedMoveDirection Result;
+		Result.X = static_cast<int16>(FMath::RoundToInt(FMath::Clamp(Direction.X, -1.0, 1.0) * MAX_int16));
+		Result.Y = static_cast<int16>(FMath::RoundToInt(FMath::Clamp(Direction.Y, -1.0, 1.0) * MAX_int16));
+		return Result;
+	}
+
+	FVector Unpack() const { return FVector(static_cast<double>(X) / MAX_int16, static_cast<double>(Y) / MAX_int16, 0.0); }
+
+	/** @return the direction as it is after a round trip through the quantization. Quantizing it again does not change it. */
+	static FVector Quantize(const FVector& Direction) { return Pack(Direction).Unpack(); }
+};
+
+/**
+ *	The movement state the owning client sends to the server, packed into a single RPC per frame.
+ *	Only the fields in DirtyMask are serialized.
+ */
+USTRUCT()
+struct FMovementStateDelta
+{
+	GENERATED_BODY()
+
+	/** The fields that changed since the last send. @see EMovementStateField */
+	uint8 DirtyMask = 0;
+
+	uint8 WallRunSide = 0;
+	uint8 ImpulseMovementMode = 0;
+	uint8 GrappleHookState = 0;
+	bool IsStimmy = false;
+	FVector MoveDirection = FVector::ZeroVector;
+
+	/** Serializes the dirty mask followed by only the dirty fields. */
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FMovementStateDelta> : public TStructOpsTypeTraitsBase2<FMovementStateDelta>
+{
+	enum
+	{
+		WithNetSerializer = true
+	};
+};
+
+/**
+ *	The movement state simulated proxies need, replicated as a single property when bUsePackedMovementState is set.
+ *	Replaces IsSliding, the proxy extrapolation properties and the wall run side and impulse movement mode multicasts.
+ *	Serialized by FMyMovementNetStateNetSerializer when replicating with Iris.
+ */
+USTRUCT()
+struct FMyMovementNetState
+{
+	GENERATED_BODY()
+
+	uint8 WallRunSide = 0;
+	uint8 ImpulseMovementMode = 0;
+
+	/** @see EProxyExtrapolationModel */
+	uint8 ProxyExtrapolationModel = EXTRAPOLATE_Default;
+
+	bool IsSliding = false;
+
+	/** Only serialized for the extrapolation models that use it. @see UsesExtrapolationDirection() */
+	FVector ProxyExtrapolationDirection = FVector::ZeroVector;
+
+	/** Only serialized while grappling. */
+	FVector ProxyExtrapolationAnchor = FVector::ZeroVector;
+
+	/** @return true if the extrapolation model uses the direction, the wall run direction or the floor normal of a slide. */
+	FORCEINLINE bool UsesExtrapolationDirection() const { return ProxyExtrapolationModel == EXTRAPOLATE_WallRun || ProxyExtrapolationModel == EXTRAPOLATE_Slide; }
+
+	/** @return true if the extrapolation model uses the anchor. */
+	FORCEINLINE bool UsesExtrapolationAnchor() const { return ProxyExtrapolationModel == EXTRAPOLATE_Grapple; }
+
+	/** Serializes the discrete state packed into two bytes, followed by the quantized vectors the extrapolation model uses. */
+	bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+
+	bool operator==(const FMyMovementNetState& Other) const;
+	bool operator!=(const FMyMovementNetState& Other) const { return !(*this == Other); }
+};
+
+template<>
+struct TStructOpsTypeTraits<FMyMovementNetState> : public TStructOpsTypeTraitsBase2<FMyMovementNetState>
+{
+	enum
+	{
+		WithNetSerializer = true,
+		WithIdenticalViaEquality = true
+	};
+};
+
+/**
+ *	One-shot cosmetic movement events, sent to simulated proxies over an unreliable channel.
+ *	EVENT_Jump - the character jumped off the ground.
+ *	EVENT_WallJump - the character jumped off a wall.
+ *	EVENT_Blink - the character started a blink.
+ *	EVENT_SlideJump - the character was launched by a slide jump.
+ */
+enum EMovementCosmeticEvent : uint8
+{
+	EVENT_Jump,
+	EVENT_WallJump,
+	EVENT_Blink,
+	EVENT_SlideJump,
+	EVENT_MAX
+};
+
+/** The discrete movement state used by the animations, which changes instantly instead of being smoothed like the location. */
+struct FDiscreteMovementState
+{
+	TEnumAsByte<EImpulseMovementMode> ImpulseMovementMode;
+	TEnumAsByte<EWallRunSide> WallRunSide;
+	bool IsSliding = false;
+
+	/** The number of times each EMovementCosmeticEvent happened, wrapping around. Animations detect events by the count changing. */
+	uint8 CosmeticEventCounts[EVENT_MAX] = {};
+};
+
+/** A discrete movement state received by a simulated proxy and the time it was received. */
+struct FDiscreteMovementSnapshot
+{
+	double ReceiveTime = 0.0;
+	FDiscreteMovementState State;
+};
+
+/** A packed ServerMove held by the server move buffer, the time it was received and the client time stamp of its newest move. */
+struct FBufferedServerMove
+{
+	double ReceiveTime = 0.0;
+	float TimeStamp = 0.f;
+	FCharacterServerMovePackedBits PackedBits;
+};
+
+/**
+ *	The data of a single move sent to the server when bUsePackedMovementState is set. Adds the movement direction, which then
+ *	arrives in order with the moves instead of through the state RPC. Serialized into the packed ServerMove bits, which are
+ *	sent as they are with both the legacy replication and Iris.
+ */
+struct FMyCharacterNetworkMoveData : public FCharacterNetworkMoveData
+{
+	typedef FCharacterNetworkMoveData Super;
+
+	/** The movement direction of the move, only the horizontal part is sent. */
+	FVector MoveDirection = FVector::ZeroVector;
+
+	virtual void ClientFillNetworkMoveData(const FSavedMove_Character& ClientMove, ENetworkMoveType MoveType) override;
+
+	virtual bool Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType) override;
+};
+
+/** Holds the FMyCharacterNetworkMoveData of the new, pending and old move. */
+struct FMyCharacterNetworkMoveDataContainer : public FCharacterNetworkMoveDataContainer
+{
+	FMyCharacterNetworkMoveDataContainer();
+
+	FMyCharacterNetworkMoveData MoveData[3];
+};
+
 UCLASS(BlueprintType)
 class IMPULSE_API UMyCharacterMovementComponent : public UCharacterMovementComponent
 {
@@ -20,6 +247,7 @@ class IMPULSE_API UMyCharacterMovementComponent : public UCharacterMovementCompo
 	GENERATED_BODY()
 
 	friend class FSavedMove_MyMovement;
+	friend struct FMovementPredictionTrace;
 
 	/** Constructor */
 	UMyCharacterMovementComponent();
@@ -30,81 +258,111 @@ class IMPULSE_API UMyCharacterMovementComponent : public UCharacterMovementCompo
 
 private:
 	
-	/** The maximum ground speed while running. Also determines maximum lateral speed when falling. */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "My Character Movement|Defaults: Grounded", Meta = (AllowPrivateAccess = "true"))
-	float DefaultMaxRunSpeed = 550.0f;
-
-	/** The default maximum acceleration while running. */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "My Character Movement|Defaults: Grounded", Meta = (AllowPrivateAccess = "true"))
-	float DefaultMaxRunAcceleration = 10000.0f;
-
 	/**
-	 * Setting that affects movement control. Higher values allow faster changes in direction.
-	 * If bUseSeparateBrakingFriction is false, also affects the ability to stop more quickly when braking (whenever Acceleration is zero), where it is multiplied by BrakingFrictionFactor.
-	 * When braking, this property allows you to control how much friction is applied when moving across the ground, applying an opposing force that scales with current velocity.
-	 * This can be used to simulate slippery surfaces such as ice or oil by changing the value (possibly based on the material pawn is standing on).
-	 * @see BrakingDecelerationWalking, BrakingFriction, bUseSeparateBrakingFriction, BrakingFrictionFactor
+	 *	The shared movement tuning used by this component.
+	 *	Uses the defaults of UMyMovementTuning if no asset is set.
 	 */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "My Character Movement|Defaults: Grounded", Meta = (AllowPrivateAccess = "true"))
-	float DefaultGroundFriction = 5.f;
+	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Defaults", Meta = (AllowPrivateAccess = "true"))
+	UMyMovementTuning* MovementTuning;
 
-	/**
-	 * Deceleration when walking and not applying acceleration. This is a constant opposing force that directly lowers velocity by a constant value.
-	 * @see GroundFriction, MaxAcceleration
-	 */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "My Character Movement|Defaults: Grounded", Meta = (AllowPrivateAccess = "true"))
-	float DefaultBrakingDecelerationWalking = 10000.f;
+	/** The tuning currently in use, never null. Only ever read so the tuning can be shared between all characters. */
+	const UMyMovementTuning* Tuning;
+
+	/** Applies the default values of the tuning to the base character movement properties. */
+	void ApplyTuning();
+
+	/** The local-only camera layer that applies the slide and wall run tilt to the view. */
+	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Camera", Meta = (AllowPrivateAccess = "true"))
+	TSubclassOf<UMovementCameraModifier> CameraModifierClass;
+
+	/** The camera modifier added to the local player's camera manager. */
+	TWeakObjectPtr<UCameraModifier> CameraModifier;
+
+	/** Adds the movement camera modifier to the local player's camera manager if it has not been added yet. */
+	void AddCameraModifier();
 
 	/**
-	 * Deceleration when walking and not applying acceleration. This is a constant opposing force that directly lowers velocity by a constant value.
-	 * @see GroundFriction, MaxAcceleration
+	 *	If true, GetSpeedState() is computed once per substep instead of on every max speed and acceleration query.
+	 *	Turn it off to compare the Calc Velocity stat with and without the cache.
 	 */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "My Character Movement|Defaults: InAir", Meta = (AllowPrivateAccess = "true"))
-	float DefaultGravityScale = 1.75f;
+	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Defaults", Meta = (AllowPrivateAccess = "true"))
+	bool bCacheSpeedState = true;
+
+	/** Result of GetSpeedState() for the current substep, mutable so it can be filled from the const max speed queries. */
+	mutable EMovementSpeedState CachedSpeedState = SPEED_Run;
+
+	/** True while CachedSpeedState is valid. Cleared at the start of every frame and substep, and when the movement mode or modifiers change. */
+	mutable bool bSpeedStateCached = false;
 
-	/** Initial velocity (instantaneous vertical acceleration) when jumping. */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "My Character Movement|Defaults: InAir", Meta = (AllowPrivateAccess = "true"))
-	float DefaultJumpZVelocity = 550.f;
+	/** Makes the next GetSpeedState() compute the speed state again. */
+	FORCEINLINE void InvalidateSpeedState() { bSpeedStateCached = false; }
 
 	/**
-	 * When falling, amount of lateral movement control available to the character.
-	 * 0 = no control, 1 = full control at max speed of MaxWalkSpeed.
+	 *	Determines the movement speed state without using the cache.
+	 *	@return the current movement speed state.
 	 */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "My Character Movement|Defaults: InAir", Meta = (AllowPrivateAccess = "true"))
-	float DefaultAirControl = 0.2f;
+	EMovementSpeedState CalcSpeedState() const;
+
+public:
+
+	/** Returns the movement tuning currently in use. */
+	FORCEINLINE const UMyMovementTuning& GetTuning() const { return *Tuning; }
 
 	/**
-	 * When falling, multiplier applied to AirControl when lateral velocity is less than AirControlBoostVelocityThreshold.
-	 * Setting this to zero will disable air control boosting. Final result is clamped at 1.
+	 *	Determines the movement state used to look up the maximum speed and acceleration.
+	 *	Cached for the rest of the substep, see bCacheSpeedState.
+	 *	@return the current movement speed state.
 	 */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "My Character Movement|Defaults: InAir", Meta = (AllowPrivateAccess = "true"))
-	float DefaultAirControlBoostMultiplier = 0.f;
+	EMovementSpeedState GetSpeedState() const;
 
 	/**
-	 * When falling, if lateral velocity magnitude is less than this value, AirControl is multiplied by AirControlBoostMultiplier.
-	 * Setting this to zero will disable air control boosting.
+	 *	Determines how much the camera should be tilted for the current movement.
+	 *	Applied by UMovementCameraModifier, the control rotation is never changed so the tilt costs no bandwidth.
+	 *	@return the target roll of the camera in degrees.
 	 */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "My Character Movement|Defaults: InAir", Meta = (AllowPrivateAccess = "true"))
-	float DefaultAirControlBoostVelocityThreshold = 0.f;
+	float GetCameraRoll() const;
+
+#pragma endregion
+
+#pragma region Movement Modifiers
+
+private:
+
+	/** Bit mask of the active movement modifiers, one bit per EMovementModifier. Saved with every move so replays apply the same physics values. */
+	uint8 ActiveMovementModifiers = 0;
+
+	/** True when the active movement modifiers changed and the physics values have to be recomputed before the next move. */
+	bool bMovementModifiersDirty = false;
 
 	/**
-	 * Friction to apply to lateral air movement when falling.
-	 * If bUseSeparateBrakingFriction is false, also affects the ability to stop more quickly when braking (whenever Acceleration is zero).
-	 * @see BrakingFriction, bUseSeparateBrakingFriction
+	 *	Sets the active movement modifiers, marking the physics values to be recomputed if they changed.
+	 *	@param NewModifiers the new bit mask of active movement modifiers.
 	 */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "My Character Movement|Defaults: InAir", Meta = (AllowPrivateAccess = "true"))
-	float DefaultFallingLateralFriction = 0.1f;
+	void SetMovementModifiers(uint8 NewModifiers);
 
-	/** The current maximum ground speed while running. Also determines maximum lateral speed when falling. */
-	float CurrentMaxRunSpeed;
-
-	/** The current maximum acceleration while running. */
-	float CurrentMaxRunAcceleration;
+	/** Recomputes GroundFriction and GravityScale from the tuning and the active movement modifiers if they changed. */
+	void ApplyMovementModifiers();
 
 public:
 
-	/** Called on tick to determine if the camera should be tilted during movements. */
-	void CameraTick() const;
+	/**
+	 *	Activates a movement modifier. The physics values are recomputed before the next move.
+	 *	@param Modifier the modifier to activate.
+	 */
+	void PushMovementModifier(EMovementModifier Modifier);
+
+	/**
+	 *	Deactivates a movement modifier. The physics values are recomputed before the next move.
+	 *	@param Modifier the modifier to deactivate.
+	 */
+	void PopMovementModifier(EMovementModifier Modifier);
+
+	/**
+	 *	Determines if a movement modifier is currently active.
+	 *	@param Modifier the modifier being checked.
+	 *	@return true if the modifier is active.
+	 */
+	FORCEINLINE bool HasMovementModifier(const EMovementModifier Modifier) const { return (ActiveMovementModifiers & (1 << Modifier)) != 0; }
 
 #pragma endregion
 
@@ -123,36 +381,10 @@ public:
 	 */
 	void SetJumping(bool bJumped);
 
-	UFUNCTION(Server, Reliable, WithValidation)
-	void ServerSetJumping(bool bJumped);
-
-	UFUNCTION(NetMulticast, Reliable, WithValidation)
-	void MultiSetJumping(bool bJumped);
-
-	bool Jumped;
-	
-	void JumpedFalse();
-
 #pragma endregion
 
 #pragma region Sprinting
 
-private:
-
-	/** The default maximum ground speed when sprinting. Also determines the maximum lateral speed while falling. */
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "My Character Movement|Sprinting", Meta = (AllowPrivateAccess = "true"))
-	float DefaultMaxSprintSpeed = 825.0f;
-
-	/** The default maximum acceleration when sprinting. */
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "My Character Movement|Sprinting", Meta = (AllowPrivateAccess = "true"))
-	float DefaultMaxSprintAcceleration = 10000.0f;
-
-	/** The current maximum ground speed while sprinting. Also determines the maximum lateral speed when falling. */
-	float CurrentMaxSprintSpeed;
-
-	/** The current maximum acceleration while sprinting. */
-	float CurrentMaxSprintAcceleration;
-	
 public:
 
 	/**
@@ -173,21 +405,15 @@ public:
 
 private:
 
-	/** The default maximum ground speed while walking and when crouched. */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "My Character Movement|Crouching", Meta = (AllowPrivateAccess = "true"))
-	float DefaultMaxWalkSpeedCrouched = 300.f;
-
 	/** True while the crouch key is held down, false otherwise. */
 	bool WantsToCrouch = false;
 	
 public:
 
 	/** Called when the player presses the crouch key to set WantsToCrouch to true. */
-	UFUNCTION(Client, Unreliable)
 	void BeginCrouch();
 
 	/** Called when the player releases the crouch key to set WantsToCrouch to false. */
-	UFUNCTION(Client, Unreliable)
 	void EndCrouch();
 	
 #pragma endregion
@@ -195,10 +421,6 @@ public:
 #pragma region Sliding
 
 private:
-
-	/** The maximum ground speed when sliding. */
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "My Character Movement|Sliding", Meta = (AllowPrivateAccess = "true"))
-	float MaxSlideSpeed = 1300.f;
 	
 	/** True if the required keys are being pressed for sliding. */
 	bool SlideKeysDown;
@@ -215,23 +437,30 @@ public:
 
 	/**
 	 *	True if currently sliding. False if not sliding.
-	 *	Replicated for third person animations.
+	 *	Set by the server from the slide flag of the moves and replicated for third person animations.
 	 */
-	UPROPERTY(Replicated)
+	UPROPERTY(ReplicatedUsing = OnRep_IsSliding)
 	bool IsSliding = false;
+
+	/** Buffers the new sliding state on simulated proxies. */
+	UFUNCTION()
+	void OnRep_IsSliding();
 	
 	/**
-	 *	Sets the physics values to be able to slide and calls the server to do the same.
-	 *	@see ServerBeginSlide().
+	 *	Requests to start sliding. The request is sent to the server with the moves through FLAG_Slide.
+	 *	@see UpdateSlideState().
 	 */
 	void BeginSlide();
 
 	/**
-	 *	Resets the physics values to be able to slide and calls the server to do the same.
-	 *	@see ServerEndSlide().
+	 *	Requests to stop sliding. The request is sent to the server with the moves through FLAG_Slide.
+	 *	@see UpdateSlideState().
 	 */
 	void EndSlide();
 
+	/** Starts or stops sliding to match bWantsToSlide. Called before every move, including replayed moves and moves on the server. */
+	void UpdateSlideState();
+
 	/** Lets the player slide after SlideCooldown only if not holding the slide keys still*/
 	void AllowSlide();
 
@@ -244,9 +473,16 @@ public:
 	 */
 	bool AreRequiredSlideKeysDown() const;
 
-	/** Applies the force to player to be able to slide. */
+	/** Applies the force to player to be able to slide, or ends the slide if the keys or the slope no longer allow it. */
 	void DoSlide();
 
+	/**
+	 *	Applies the slide force for the current floor. Only reads the floor and the velocity, so the owning client and the server
+	 *	apply the same force for the same move.
+	 *	@return true if the character is still moving down the slope.
+	 */
+	bool ApplySlideForce();
+
 	/**
 	 *	Calculates the force that should be applied to the player based on the slope of the floor.
 	 *	@param FloorNormal the normal vector of the floor the player is standing on.
@@ -254,23 +490,11 @@ public:
 	 */
 	static FVector CalcFloorInfluence(FVector FloorNormal);
 
-	/** Sets the rotation of the camera while sliding. */
-	void SlideCameraRotate() const;
-
 	/**
-	 *	Sets the value of IsSliding to other clients.
-	 *	@param Sliding the new value of IsSliding.
+	 *	Calculates the roll of the camera while sliding based on the direction and speed of the slide.
+	 *	@return the target roll of the camera while sliding.
 	 */
-	UFUNCTION(NetMulticast, Reliable, WithValidation)
-	void MultiSetIsSliding(const bool Sliding);
-
-	/** Sets the physics values to be able to slide on the server. */
-	UFUNCTION(Server, Reliable, WithValidation)
-	void ServerBeginSlide();
-
-	/** Resets the physics values to be able to slide on the server. */
-	UFUNCTION(Server, Reliable, WithValidation)
-	void ServerEndSlide();
+	float GetSlideCameraRoll() const;
 
 #pragma endregion
 	
@@ -278,22 +502,6 @@ public:
 
 private:
 
-	/** The amount of vertical room between the two line traces when checking if the character is still on the wall. */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "My Character Movement|Wall Running", Meta = (AllowPrivateAccess = "true"))
-	float LineTraceVerticalTolerance = 10.0f;
-
-	/** The maximum speed while wall running. */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "My Character Movement|Wall Running", Meta = (AllowPrivateAccess = "true"))
-	float WallRunSpeed = 1200.0f;
-
-	/** The force applied horizontally when jumping off of a wall. */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "My Character Movement|Wall Running", Meta = (AllowPrivateAccess = "true"))
-	float HorizontalWallJumpOffForce = 400.f;
-
-	/** The force applied vertically when jumping off of a wall. */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "My Character Movement|Wall Running", Meta = (AllowPrivateAccess = "true"))
-	float VerticalWallJumpOffForce = 600.f;
-
 	/** Called when the owning actor hits an actor to determine if wall run should begin. */
 	UFUNCTION()
 	void OnActorHit(AActor* SelfActor, AActor* OtherActor, FVector NormalImpulse, const FHitResult& Hit);
@@ -314,17 +522,17 @@ public:
 	 */
 	EWallRunSide WallRunSide;
 
-	UFUNCTION(Server, Reliable, WithValidation)
-	void ServerSetWallRunSide(EWallRunSide WRSide);
-
 	UFUNCTION(NetMulticast, Reliable, WithValidation)
 	void MultiSetWallRunSide(EWallRunSide WRSide);
 	
 	/** Requests that the character begins wall running. Will return false if the required keys are not being pressed. */
 	bool BeginWallRun();
 
-	/** Called while wall running to rotate the camera based on the current wall run direction. */
-	void WallRunCameraRotate(float Roll) const;
+	/**
+	 *	Calculates the roll of the camera while wall running based on the current wall run side.
+	 *	@return the target roll of the camera, 0 if not wall running.
+	 */
+	float GetWallRunCameraRoll() const;
 
 	/** Called when jumping while wall running to launch the player off of the wall. */
 	void WallRunJump();
@@ -344,6 +552,23 @@ public:
 	 *	@return true if the player is next to a wall that can be wall ran.
 	 */
 	bool IsNextToWall(float VerticalTolerance = 0.0f) const;
+
+	/**
+	 *	Gets the line IsNextToWall() traces along for the current wall run direction and side.
+	 *	@param OutStart the start of the trace.
+	 *	@param OutEnd the end of the trace.
+	 */
+	void GetNextToWallTrace(FVector& OutStart, FVector& OutEnd) const;
+
+	/**
+	 *	Traces for a wall along a line. Shared with FMyMovementSimulation, which has no movement component to call IsNextToWall() on.
+	 *	@param World the world to trace in.
+	 *	@param Start the start of the trace.
+	 *	@param End the end of the trace.
+	 *	@param VerticalTolerance if positive, traces once above and once below the line instead of along it.
+	 *	@return true if a wall was hit.
+	 */
+	static bool TraceNextToWall(const UWorld* World, const FVector& Start, const FVector& End, float VerticalTolerance);
 	
 	/**
 	 *	Finds the wall run direction and side based on the specified surface normal.
@@ -383,18 +608,6 @@ public:
 
 private:
 
-	/** Amount of force applied in the direction of the blink. */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "My Character Movement|Blink", Meta = (AllowPrivateAccess = "true"))
-	float BlinkStrength = 10000.f;
-
-	/** The duration of the blink. */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "My Character Movement|Blink", Meta = (AllowPrivateAccess = "true"))
-	float BlinkDuration = 0.15f;
-
-	/** The time it takes to be able to reuse the blink. */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "My Character Movement|Blink", Meta = (AllowPrivateAccess = "true"))
-	float BlinkCooldown = 1.f;
-
 	/** True if not currently blinking and not on cooldown. */
 	bool CanDodge = true;
 	
@@ -418,18 +631,6 @@ public:
 
 private:
 
-	/** Multiplier applied to all movements while the stimmy is active. */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "My Character Movement|Stimmy", Meta = (AllowPrivateAccess = "true"))
-	float StimmySpeedMultiplier = 1.5f;
-
-	/** The duration of the stimmy. */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "My Character Movement|Stimmy", Meta = (AllowPrivateAccess = "true"))
-	float StimmyDuration = 10.f;
-
-	/** The time it takes to be able to reuse the stimmy. */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "My Character Movement|Stimmy", Meta = (AllowPrivateAccess = "true"))
-	float StimmyCooldown = 8.f;
-
 	/** True if the stimmy is currently active. */
 	bool IsStimmy = false;
 
@@ -438,27 +639,11 @@ private:
 	
 public:
 
-	/** Applies the StimmySpeedMultiplier to all the movements. */
+	/** Starts the stimmy, applying the StimmySpeedMultiplier to all the movements. */
 	void StartStimmy();
 
-	/** Resets all the movement speeds to their default values. */
+	/** Ends the stimmy, returning all the movement speeds to their default values. */
 	void EndStimmy();
-	
-	/** Applies the StimmySpeedMultiplier to all the movements on the server. */
-	UFUNCTION(Server, Unreliable)
-	void ServerSetStimmySpeed();
-
-	/** Resets all the movement speeds to their default values on the server. */
-	UFUNCTION(Server, Unreliable)
-	void ServerEndStimmySpeed();
-
-	/**
-	 *	Sets the value of IsStimmy on the server to be used in other server functions
-	 *	@param bStimmy new value of IsStimmy
-	 *	@see PhysWallRunning()
-	 */
-	UFUNCTION(Server, Unreliable)
-	void ServerSetStimmy(bool bStimmy);
 
 	/** Called when StimmyCooldown is finished to allow the stimmy again. */
 	void ResetStimmy();
@@ -469,30 +654,14 @@ public:
 
 private:
 
-	/** The value of the gravity scale only while slide jumping. */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "My Character Movement|SlideJump", Meta = (AllowPrivateAccess = "true"))
-	float SlideJumpGravityScale = 2.5f;
-
-	/** The horizontal force applied when slide jumping. */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "My Character Movement|SlideJump", Meta = (AllowPrivateAccess = "true"))
-	float HorizontalSlideJumpForce = 1500.f;
-
-	/** The vertical force applied when slide jumping. */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "My Character Movement|SlideJump", Meta = (AllowPrivateAccess = "true"))
-	float VerticalSlideJumpForce = 2000.f;
-
-	/** The time it takes to be able to slide jump again after starting the ability. */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "My Character Movement|SlideJump", Meta = (AllowPrivateAccess = "true"))
-	float SlideJumpCooldown = 6.f;
-
 	/** True once the SlideJumpCooldown is finished to be able to slide jump again. */
 	float CanSlideJump = true;
 	
 public:
 
 	/**
-	 *	Calls the start of the slide jump on the server to launch the character.
-	 *	@see ServerSlideJump().
+	 *	Requests a slide jump with the next move, the launch is predicted and performed in order with the moves on the server.
+	 *	@see DoSlideJump().
 	 */
 	UFUNCTION()
 	void SlideJump();
@@ -500,11 +669,8 @@ public:
 	/** Sets CanSlideJump to true once the SlideJumpCooldown is finished. */
 	void AllowSlideJump();
 	
-	/** Launches the player for the slide jump. */
-	UFUNCTION(Server, Unreliable)
-	void ServerSlideJump();
-
-	
+	/** Launches the player for the slide jump. Called at the end of the move that requested it, on the owning client and the server. */
+	void DoSlideJump();
 
 #pragma endregion
 
@@ -512,21 +678,6 @@ public:
 
 private:
 
-	/** The maximum distance the grapple hook travels before breaking. */
-	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Grapple Hook", Meta = (AllowPrivateAccess = "true"))
-	float GrappleDistance = 4000.f;
-
-	/** The force applied to the player by the grapple. */
-	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Grapple Hook", Meta = (AllowPrivateAccess = "true"))
-	float GrapplePullForce = 200000.f;
-
-	/** The instantaneous velocity of the player when the grapple attaches. */
-	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Grapple Hook", Meta = (AllowPrivateAccess = "true"))
-	float InstantaneousVelocityFromGrapple = 1200.f;
-
-	/** The time it takes to be able to use the grapple again after it is destroyed. */
-	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Grapple Hook", Meta = (AllowPrivateAccess = "true"))
-	float GrappleCooldown = 8.f;
 	
 	/** The class used as the hook for the grapple hook ability. */
 	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Grapple Hook", Meta = (AllowPrivateAccess = "true"))
@@ -603,21 +754,12 @@ public:
 	void OnGrappleHookDestroyed(AActor* DestroyedActor);
 
 	/**
-	 *	Sets the grapple hook state and calls to be set on the server.
+	 *	Sets the grapple hook state, which is sent to the server with the next movement state update.
 	 *	@param NewGrappleHookState the new grapple hook state being set.
-	 *	@see ServerSetGrappleHookState()
+	 *	@see FlushServerState()
 	 */
 	void SetGrappleHookState(EGrappleHookState NewGrappleHookState);
 
-	/**
-	 *	Sets the grapple hook state on the server to be used in other server functions.
-	 *	@param NewGrappleHookState the new grapple hook state being set.
-	 *	@note this function should not be called directly, set the grapple hook state for the client first.
-	 *	@see SetGrappleHookState()
-	 */
-	UFUNCTION(Server, Reliable, WithValidation)
-	void ServerSetGrappleHookState(EGrappleHookState NewGrappleHookState);
-
 	/**
 	 *	Determines if the inputted grapple hook state is the same as the current grapple hook state.
 	 *	@param GrappleHookState grapple hook state that is being checked as the current grapple hook state.
@@ -639,6 +781,562 @@ public:
 
 #pragma endregion
 
+#pragma region Net Update Frequency
+
+private:
+
+	/** The net update frequency of the owner while wall running, grappling, blinking or slide jumping. */
+	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Replication", Meta = (AllowPrivateAccess = "true"))
+	float HighNetUpdateFrequency = 100.f;
+
+	/** The net update frequency of the owner while moving normally. */
+	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Replication", Meta = (AllowPrivateAccess = "true"))
+	float MovingNetUpdateFrequency = 60.f;
+
+	/** The net update frequency of the owner while grounded and idle or walking slowly. */
+	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Replication", Meta = (AllowPrivateAccess = "true"))
+	float IdleNetUpdateFrequency = 10.f;
+
+	/** The ground speed below which the character is considered idle. */
+	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Replication", Meta = (AllowPrivateAccess = "true"))
+	float IdleSpeedThreshold = 150.f;
+
+	/** How fast the net update frequency interpolates towards the target frequency when lowering it. Raising it is instant. */
+	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Replication", Meta = (AllowPrivateAccess = "true"))
+	float NetUpdateFrequencyInterpSpeed = 4.f;
+
+	/** How long the character has to be completely still before going dormant. Zero or less disables dormancy. */
+	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Replication", Meta = (AllowPrivateAccess = "true"))
+	float DormancyDelay = 2.f;
+
+	/** How long the character has been completely still for. */
+	float StillTime = 0.f;
+
+	/** True while the replication graph is boosting the owner. */
+	bool bReplicationBoosted = false;
+
+	/**
+	 *	Determines if the character is in a movement state that covers a lot of distance quickly.
+	 *	@return true if wall running, grappling, blinking or slide jumping.
+	 */
+	bool IsInHighVelocityState() const;
+
+	/**
+	 *	Tells the replication graph to boost or stop boosting the owner. Does nothing if the server is not using UImpulseReplicationGraph.
+	 *	@param bBoosted true to boost the owner.
+	 */
+	void SetReplicationBoost(bool bBoosted);
+
+	/**
+	 *	Determines the net update frequency the owner should replicate at for the current movement.
+	 *	@return the target net update frequency.
+	 */
+	float GetTargetNetUpdateFrequency() const;
+
+	/**
+	 *	Moves the net update frequency of the owner towards the target frequency and puts the owner to sleep when it has been still for long enough.
+	 *	Only called on the server.
+	 *	@param DeltaTime frame time to advance, in seconds.
+	 */
+	void UpdateNetUpdateFrequency(float DeltaTime);
+
+	/**
+	 *	Determines if the owner may go dormant. Characters controlled by a remote player never go dormant
+	 *	since their owning connection still needs the actor channel for move acks and corrections.
+	 *	@return true if the owner may go dormant.
+	 */
+	bool CanGoDormant() const;
+
+#pragma endregion
+
+#pragma region Cosmetic Events
+
+private:
+
+	/** The events that happened on the server this frame and still have to be sent to simulated proxies. One bit per EMovementCosmeticEvent. */
+	uint8 PendingCosmeticEvents = 0;
+
+	/** Sequence number of the last batch of events sent by the server. */
+	uint8 CosmeticEventSequence = 0;
+
+	/** Sequence number of the last batch of events received by a simulated proxy. */
+	uint8 LastReceivedCosmeticEventSequence = 0;
+
+	/** True once a simulated proxy has received its first batch of events. */
+	bool bReceivedCosmeticEvent = false;
+
+	/** The number of times each event happened on this machine. */
+	uint8 CosmeticEventCounts[EVENT_MAX] = {};
+
+	/**
+	 *	Records a cosmetic event on the machines that simulate it and queues it for simulated proxies on the server.
+	 *	@param Event the event that happened.
+	 */
+	void AddCosmeticEvent(EMovementCosmeticEvent Event);
+
+	/** Sends every event queued this frame to simulated proxies in a single unreliable multicast. Only called on the server. */
+	void FlushCosmeticEvents();
+
+public:
+
+	/**
+	 *	Delivers a batch of events to simulated proxies. Batches that arrive late or twice are dropped by their sequence number.
+	 *	@param Sequence the sequence number of the batch.
+	 *	@param Events the events in the batch, one bit per EMovementCosmeticEvent.
+	 */
+	UFUNCTION(NetMulticast, Unreliable)
+	void MultiCosmeticEvents(uint8 Sequence, uint8 Events);
+
+#pragma endregion
+
+#pragma region Discrete Movement State
+
+private:
+
+	/** The number of discrete movement states a simulated proxy can buffer before the oldest one is applied early. */
+	static constexpr int32 DiscreteStateBufferSize = 16;
+
+	/** Ring buffer of the discrete movement states received by a simulated proxy that have not been applied yet. */
+	FDiscreteMovementSnapshot DiscreteStateBuffer[DiscreteStateBufferSize];
+
+	/** Index of the oldest snapshot in DiscreteStateBuffer. */
+	int32 DiscreteStateHead = 0;
+
+	/** Number of snapshots in DiscreteStateBuffer. */
+	int32 DiscreteStateCount = 0;
+
+	/** The discrete movement state at the current render time of a simulated proxy. */
+	FDiscreteMovementState InterpolatedDiscreteState;
+
+	/**
+	 *	Builds the discrete movement state from the current values on this machine.
+	 *	@return the current discrete movement state.
+	 */
+	FDiscreteMovementState MakeDiscreteMovementState() const;
+
+	/** Buffers the current discrete movement state on simulated proxies, called whenever a replicated value changes. */
+	void PushDiscreteMovementState();
+
+	/** Applies every buffered discrete movement state that is older than the smoothing delay of the location. */
+	void UpdateDiscreteMovementState();
+
+public:
+
+	/**
+	 *	Returns the discrete movement state the animations should use.
+	 *	Simulated proxies return the state delayed by the same amount as the smoothed location, so animations never run ahead of the mesh.
+	 *	@return the discrete movement state to animate with.
+	 */
+	FDiscreteMovementState GetDiscreteMovementState() const;
+
+#pragma endregion
+
+#pragma region Proxy Extrapolation
+
+private:
+
+	/** The longest time simulated proxies extrapolate for without a movement update before holding their position. */
+	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Replication", Meta = (AllowPrivateAccess = "true"))
+	float MaxProxyExtrapolationTime = 0.25f;
+
+	/** The dead reckoning model simulated proxies should use, set by the server. @see EProxyExtrapolationModel */
+	UPROPERTY(Replicated)
+	uint8 ProxyExtrapolationModel = EXTRAPOLATE_Default;
+
+	/**
+	 *	The direction used by the dead reckoning model, set by the server.
+	 *	The wall run direction while wall running and the floor normal while sliding.
+	 */
+	UPROPERTY(Replicated)
+	FVector_NetQuantizeNormal ProxyExtrapolationDirection;
+
+	/** The location of the grapple anchor while grappling, set by the server. */
+	UPROPERTY(Replicated)
+	FVector_NetQuantize ProxyExtrapolationAnchor;
+
+	/** How long the simulated proxy has been extrapolating since the last movement update. */
+	float ProxyExtrapolationTime = 0.f;
+
+	/** Chooses the dead reckoning model for simulated proxies from the current movement. Only called on the server. */
+	void UpdateProxyExtrapolation();
+
+	/**
+	 *	Moves a simulated proxy using the dead reckoning model replicated by the server.
+	 *	@param DeltaTime frame time to advance, in seconds.
+	 */
+	void ExtrapolateProxy(float DeltaTime);
+
+#pragma endregion
+
+#pragma region Simulated Proxy
+
+private:
+
+	/**
+	 *	The tick group simulated proxies tick in. They only smooth their location and update the state read by the animations,
+	 *	so they can tick later than autonomous proxies and the server if nothing reads them earlier in the frame.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Replication", Meta = (AllowPrivateAccess = "true"))
+	TEnumAsByte<ETickingGroup> SimulatedProxyTickGroup = TG_PrePhysics;
+
+	/**
+	 *	The tick of simulated proxies. Only updates the discrete movement state and runs the engine smoothing, none of the ability logic runs.
+	 *	@param DeltaTime frame time to advance, in seconds.
+	 *	@param TickType the type of the tick.
+	 *	@param ThisTickFunction the tick function that is ticking the component.
+	 */
+	void TickSimulatedProxy(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction);
+
+#pragma endregion
+
+#pragma region Server Controlled AI
+
+private:
+
+	/**
+	 *	Determines if the owner is controlled by AI on the server. Such characters move without saved moves or ServerMoves,
+	 *	so none of the client prediction, camera or state RPC logic applies to them.
+	 *	@return true if the owner is not controlled by a player and this is the server.
+	 */
+	bool IsServerControlledAI() const;
+
+	/**
+	 *	The tick of AI controlled characters on the server. Runs the movement and the server replication work only.
+	 *	@param DeltaTime frame time to advance, in seconds.
+	 *	@param TickType the type of the tick.
+	 *	@param ThisTickFunction the tick function that is ticking the component.
+	 */
+	void TickServerControlledAI(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction);
+
+	/** Multicasts the state simulated proxies need when it changes, without going through the server state RPC. */
+	void FlushServerControlledAIState();
+
+#pragma endregion
+
+#pragma region Fixed Tick Simulation
+
+public:
+
+	/**
+	 *	The offset the mesh is rendered at to interpolate between the last two fixed ticks.
+	 *	Added to the view location by UMovementCameraModifier so cameras on the capsule are smoothed as well.
+	 *	@return the render offset in world space, zero unless the fixed tick simulation is used.
+	 */
+	FVector GetFixedTickRenderOffset() const { return FixedTickRenderOffset; }
+
+private:
+
+	/**
+	 *	If true the locally controlled character only moves in whole fixed ticks. Every saved move, and so every ServerMove,
+	 *	then lasts a multiple of the fixed tick and the server steps it with the same step size as the client. The blink
+	 *	and the slide forces count fixed ticks instead of running on timers, so replays reproduce them as well.
+	 *	The time left over each frame is carried to the next one and only used to interpolate the mesh.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Replication", Meta = (AllowPrivateAccess = "true"))
+	bool bUseFixedTickSimulation = false;
+
+	/** The rate of the fixed tick, in ticks per second. */
+	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Replication", Meta = (AllowPrivateAccess = "true", ClampMin = "10", ClampMax = "120"))
+	float FixedTickRate = 60.f;
+
+	/**
+	 *	The most fixed ticks run in a single frame, the rest of a long frame is dropped instead of spiralling.
+	 *	Keep the ticks of a frame under MaxMoveDeltaTime, longer moves are clamped and stop being whole ticks.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Replication", Meta = (AllowPrivateAccess = "true", ClampMin = "1"))
+	int32 MaxFixedTicksPerFrame = 7;
+
+	/** Frame time not simulated yet, always less than one fixed tick. */
+	float FixedTickAccumulator = 0.f;
+
+	/**
+	 *	Part of a fixed tick carried between moves that are not whole ticks, like the variable step moves of server controlled AI.
+	 *	Not saved with the moves, the moves of the fixed tick simulation are whole ticks and leave it at 0.
+	 */
+	float FixedTickMoveRemainder = 0.f;
+
+	/** See GetFixedTickRenderOffset(). */
+	FVector FixedTickRenderOffset = FVector::ZeroVector;
+
+	/** Fixed ticks left until the blink ends. Saved with every move. */
+	uint8 DodgeTicksRemaining = 0;
+
+	/** Fixed ticks since the last slide force was applied. Saved with every move. */
+	uint8 SlideForceTicks = 0;
+
+	/** @return the duration of a fixed tick, in seconds. */
+	float GetFixedTickTime() const { return 1.f / FixedTickRate; }
+
+	/**
+	 *	Converts the duration of a move to fixed ticks, carrying the part of a tick it does not complete into the next move.
+	 *	@param DeltaSeconds the duration of the move, in seconds.
+	 *	@return the number of fixed ticks completed by the move.
+	 */
+	int32 GetFixedTicksInMove(float DeltaSeconds);
+
+	/**
+	 *	Ticks the movement of the locally controlled character in whole fixed ticks.
+	 *	@param DeltaTime frame time to advance, in seconds.
+	 *	@param TickType the type of the tick.
+	 *	@param ThisTickFunction the tick function that is ticking the component.
+	 */
+	void TickFixed(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction);
+
+	/**
+	 *	Advances the blink and slide force counters by the fixed ticks of a move.
+	 *	@param DeltaSeconds the duration of the move, in seconds.
+	 */
+	void AdvanceFixedTickAbilities(float DeltaSeconds);
+
+	/** Offsets the mesh between the last two fixed ticks, by the part of a tick carried in the accumulator. */
+	void UpdateFixedTickRenderOffset();
+
+#pragma endregion
+
+#pragma region Packed Movement State
+
+private:
+
+	/**
+	 *	If true the state simulated proxies need is replicated as the single packed MovementNetState instead of IsSliding,
+	 *	the proxy extrapolation properties and the multicasts, and the movement direction is sent with the moves instead of
+	 *	the state RPC. Both paths are serialized with quantization, with Iris the packed state is also delta compressed.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Replication", Meta = (AllowPrivateAccess = "true"))
+	bool bUsePackedMovementState = false;
+
+	/** The movement state of simulated proxies, set by the server. Only replicated if bUsePackedMovementState is set. */
+	UPROPERTY(ReplicatedUsing = OnRep_MovementNetState)
+	FMyMovementNetState MovementNetState;
+
+	/** The move data sent with the moves if bUsePackedMovementState is set. */
+	FMyCharacterNetworkMoveDataContainer MoveDataContainer;
+
+	/** Applies the packed movement state on simulated proxies. */
+	UFUNCTION()
+	void OnRep_MovementNetState();
+
+	/** Gathers the packed movement state on the server, after the proxy extrapolation was updated. */
+	void UpdateMovementNetState();
+
+	/**
+	 *	Sets the wall run side on the server and sends it to simulated proxies through the path in use.
+	 *	@param Side the new wall run side.
+	 */
+	void SetReplicatedWallRunSide(EWallRunSide Side);
+
+	/**
+	 *	Sets the impulse movement mode on the server and sends it to simulated proxies through the path in use.
+	 *	@param NewMoveMode the new impulse movement mode.
+	 */
+	void SetReplicatedImpulseMovementMode(EImpulseMovementMode NewMoveMode);
+
+protected:
+
+	/** Applies the movement direction sent with the move before performing it on the server. */
+	virtual void MoveAutonomous(float ClientTimeStamp, float DeltaTime, uint8 CompressedFlags, const FVector& NewAccel) override;
+
+#pragma endregion
+
+#pragma region Client Move Send Rate
+
+private:
+
+	/**
+	 *	The send interval used while wall running, grappling, blinking or slide jumping. Lower than the engine default keeps fast movement responsive.
+	 *	Never used while the engine throttles the client to a longer interval because of a low net speed or a busy server.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Replication", Meta = (AllowPrivateAccess = "true"))
+	float HighVelocitySendDeltaTime = 1.f / 60.f;
+
+	/** The send interval used while walking in a straight line on the ground, where combined moves predict well. */
+	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Replication", Meta = (AllowPrivateAccess = "true"))
+	float StraightLineSendDeltaTime = 1.f / 20.f;
+
+	/** How closely the acceleration has to follow the velocity, as a dot product, for the character to be moving in a straight line. */
+	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Replication", Meta = (AllowPrivateAccess = "true"))
+	float StraightLineDotThreshold = 0.98f;
+
+	/** The ping, in milliseconds, at which the send interval is scaled by MaxPingSendDeltaTimeScale. */
+	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Replication", Meta = (AllowPrivateAccess = "true"))
+	float PingForMaxSendDeltaTimeScale = 200.f;
+
+	/** How much the send interval grows at PingForMaxSendDeltaTimeScale. Responsiveness is bounded by the round trip, so slow connections can afford fewer moves. */
+	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Replication", Meta = (AllowPrivateAccess = "true"))
+	float MaxPingSendDeltaTimeScale = 1.5f;
+
+	/**
+	 *	Determines if the character is walking on the ground in a straight line.
+	 *	@return true if the acceleration follows the velocity closely enough.
+	 */
+	bool IsMovingInStraightLine() const;
+
+#pragma endregion
+
+#pragma region Server Move Buffer
+
+private:
+
+	/**
+	 *	If true the server holds the moves of remote clients in a small buffer and performs them at the pace of their client
+	 *	time stamps instead of in the bursts they arrive in. The client is asked to run its moves slightly faster or slower
+	 *	to keep TargetServerMoveBufferDelay buffered. Costs up to MaxServerMoveBufferDepth packets of latency.
+	 *	The client time runs up to MaxClientMoveRateAdjustment off the server time, keep the time discrepancy detection above that.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Replication", Meta = (AllowPrivateAccess = "true"))
+	bool bUseServerMoveBuffer = false;
+
+	/** How long after its client time stamp is due a move is performed, in seconds. */
+	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Replication", Meta = (AllowPrivateAccess = "true", ClampMin = "0"))
+	float TargetServerMoveBufferDelay = 0.05f;
+
+	/** Packets past this depth are performed right away so the buffer never adds more latency than this. */
+	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Replication", Meta = (AllowPrivateAccess = "true"))
+	int32 MaxServerMoveBufferDepth = 4;
+
+	/** The most the client speeds up or slows down its moves to move the buffer back towards TargetServerMoveBufferDelay. */
+	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Replication", Meta = (AllowPrivateAccess = "true", ClampMin = "0", ClampMax = "0.1"))
+	float MaxClientMoveRateAdjustment = 0.02f;
+
+	/** How often the move rate is sent to the client, in seconds. Sent unreliably, so a lost update is replaced by the next one. */
+	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Replication", Meta = (AllowPrivateAccess = "true", ClampMin = "0.05"))
+	float ClientMoveRateSendInterval = 0.25f;
+
+	/** The moves received from the client and not yet performed, oldest first. */
+	TArray<FBufferedServerMove> BufferedServerMoves;
+
+	/** The client time stamp the buffered moves are performed up to, advanced by the server frame time. */
+	float ServerMovePlayoutTime = 0.f;
+
+	/** If false the playout time is anchored to the next move received. */
+	bool bServerMovePlayoutStarted = false;
+
+	/** The client time stamp of the newest move received. */
+	float LastServerMoveTimeStamp = 0.f;
+
+	/** Time since the move rate was last sent to the client. */
+	float ClientMoveRateSendTime = 0.f;
+
+	/** On the server the move rate last sent to the client, on the owning client the rate its moves are simulated at. */
+	float ClientMoveRate = 1.f;
+
+	/** The smoothed number of moves in the buffer. */
+	float AverageServerMoveBufferDepth = 0.f;
+
+	/** The smoothed time moves spend in the buffer, in seconds. */
+	float ServerMoveBufferDelay = 0.f;
+
+	/**
+	 *	Performs the buffered moves whose client time stamp is due, updates the reported depth and delay of the buffer
+	 *	and sends the client the move rate that keeps the buffer at its target delay. Only called on the server.
+	 *	@param DeltaTime frame time to advance, in seconds.
+	 */
+	void UpdateServerMoveBuffer(float DeltaTime);
+
+	/**
+	 *	Reads the time stamp of the newest move in a packet without performing it.
+	 *	@param PackedBits the packed moves received from the client.
+	 *	@param OutTimeStamp the client time stamp of the newest move.
+	 *	@return false if the packet could not be read.
+	 */
+	bool ReadServerMoveTimeStamp(const FCharacterServerMovePackedBits& PackedBits, float& OutTimeStamp);
+
+	/**
+	 *	Sets how fast the owning client runs its moves relative to its frame time. Resent periodically by the server.
+	 *	@param MoveRate the move rate, clamped to MaxClientMoveRateAdjustment around 1.
+	 */
+	UFUNCTION(Client, Unreliable)
+	void ClientSetMoveRate(float MoveRate);
+
+public:
+
+	/** @return the number of moves currently held in the server move buffer. */
+	int32 GetServerMoveBufferDepth() const { return BufferedServerMoves.Num(); }
+
+	/** @return the smoothed number of moves held in the server move buffer. */
+	float GetAverageServerMoveBufferDepth() const { return AverageServerMoveBufferDepth; }
+
+	/** @return the smoothed latency the server move buffer adds to the moves of this connection, in seconds. */
+	float GetServerMoveBufferDelay() const { return ServerMoveBufferDelay; }
+
+#pragma endregion
+
+#pragma region Client Authoritative Movement
+
+private:
+
+	/**
+	 *	If true the server accepts the location the client ends each move at, as long as it is inside the envelope the current
+	 *	ability state could have moved the character, instead of simulating the move. Moves outside the envelope are simulated
+	 *	and corrected as usual. Trades some authority for server CPU, meant for casual playlists.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Replication", Meta = (AllowPrivateAccess = "true"))
+	bool bClientAuthoritativeMovement = false;
+
+	/** Multiplier applied to the envelope speeds to absorb differences between the client and server frame times. */
+	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Replication", Meta = (AllowPrivateAccess = "true"))
+	float MoveEnvelopeTolerance = 1.1f;
+
+	/** Distance added to the envelope of every move. Kept small since it is gained again on every move. */
+	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Replication", Meta = (AllowPrivateAccess = "true"))
+	float MoveEnvelopeSlack = 2.f;
+
+	/** How far the accepted moves of the current fall rose above their ballistic path, never more than MoveEnvelopeSlack. */
+	float FallingEnvelopeExcess = 0.f;
+
+	/** @return the fastest the character can move horizontally during the next move, from the ability state and the momentum of a fall. */
+	float GetEnvelopeHorizontalSpeed() const;
+
+	/** @return the vertical velocity a falling move starts with, from the last move and a blink the server started. */
+	float GetFallingMoveStartVelocityZ() const;
+
+	/**
+	 *	Determines if a client move stays inside the kinematic envelope of the current ability state.
+	 *	Falling moves are bounded by their ballistic path, the other moves by GetMaxSpeed() and the step height.
+	 *	@param Displacement how far the client moved the character during the move.
+	 *	@param DeltaTime the duration of the move, in seconds.
+	 *	@return true if the character could have moved that far.
+	 */
+	bool IsInsideMoveEnvelope(const FVector& Displacement, float DeltaTime) const;
+
+	/**
+	 *	Accepts the location of a client move without simulating it, if it is inside the move envelope.
+	 *	Moves that change the movement mode or jump, and moves with the grapple attached, are always simulated.
+	 *	@param MoveData the move received from the client.
+	 *	@return true if the move was accepted, false if it has to be simulated.
+	 */
+	bool TryAcceptClientMove(const FCharacterNetworkMoveData& MoveData);
+
+	/**
+	 *	Starts the requested blink and slide jump and pulls or releases the grapple at the end of a move.
+	 *	Called by OnMovementUpdated for simulated moves and by TryAcceptClientMove for accepted ones.
+	 *	@param DeltaSeconds the duration of the move, in seconds.
+	 */
+	void UpdateAbilitiesAfterMove(float DeltaSeconds);
+
+#pragma endregion
+
+#pragma region Correction Replay
+
+private:
+
+	/**
+	 *	When a correction leaves more saved moves than this to replay, runs of combinable moves are collapsed into single moves first.
+	 *	Keeps the replay cost bounded for high ping clients. Zero or less disables collapsing.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Replication", Meta = (AllowPrivateAccess = "true"))
+	int32 ReplayCollapseThreshold = 16;
+
+	/**
+	 *	Collapses runs of combinable saved moves into the last move of each run, which keeps its time stamp and takes the delta time of the whole run.
+	 *	Acks and corrections for the time stamps that were collapsed away are ignored, the next one resolves them.
+	 *	@param ClientData the prediction data holding the saved moves about to be replayed.
+	 *	@return the number of moves that were removed.
+	 */
+	int32 CollapseReplayMoves(FNetworkPredictionData_Client_Character& ClientData);
+
+#pragma endregion
+
 #pragma region Overrides
 
 protected:
@@ -651,6 +1349,9 @@ protected:
 	 *	@param DestroyingHierarchy destroying hierarchy.
 	 */
 	virtual void OnComponentDestroyed(bool DestroyingHierarchy) override;
+
+	/** Initializes the component after its properties have been loaded. */
+	virtual void InitializeComponent() override;
 	
 public:
 
@@ -668,9 +1369,6 @@ public:
 	 */
 	void SetImpulseMovementMode(EImpulseMovementMode NewMovementMode);
 
-	UFUNCTION(Server, Reliable, WithValidation)
-	void ServerSetImpulseMovementMode(EImpulseMovementMode NewMoveMode);
-
 	UFUNCTION(NetMulticast, Reliable, WithValidation)
 	void MultiSetImpulseMovementMode(EImpulseMovementMode NewMoveMode);
 
@@ -703,6 +1401,18 @@ public:
 	/** Returns maximum acceleration for the current state. */
 	virtual float GetMaxAcceleration() const override;
 
+	/** Updates the velocity of the current substep. Starts a new substep for the speed state cache. */
+	virtual void CalcVelocity(float DeltaTime, float Friction, bool bFluid, float BrakingDeceleration) override;
+
+	/** Update the character state in PerformMovement right before doing the actual position change. Applies any changed movement modifiers. */
+	virtual void UpdateCharacterStateBeforeMovement(float DeltaSeconds) override;
+
+	/** Perform jump. Records the jump as a cosmetic event when it is not being replayed. */
+	virtual bool DoJump(bool bReplayingMoves) override;
+
+	/** Simulate movement on a non-owning client. Uses the dead reckoning model of the current movement if there is one. */
+	virtual void SimulateMovement(float DeltaTime) override;
+
 	/** Handle landing against Hit surface over remaingTime and iterations, calling SetPostLandedPhysics() and starting the new movement mode. */
 	virtual void ProcessLanded(const FHitResult& Hit, float remainingTime, int32 Iterations) override;
 
@@ -711,24 +1421,97 @@ public:
 	
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
+	/** Turns off the replicated properties of the path bUsePackedMovementState does not use. */
+	virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
+
 	/**
 	 * Returns true if current movement state allows an attempt at jumping. Used by Character::CanJump().
 	 */
 	virtual bool CanAttemptJump() const override;
 
+	/** Called on the client when the server acknowledges a move as good. */
+	virtual void ClientAckGoodMove_Implementation(float TimeStamp) override;
+
+protected:
+
+	/** Sends the packed move data to the server. Used to stamp traced inputs with the move that carries them. */
+	virtual void CallServerMovePacked(const FSavedMove_Character* NewMove, const FSavedMove_Character* PendingMove, const FSavedMove_Character* OldMove) override;
+
+	/** Moves the locally controlled character and sends the move to the server. Quantizes the move direction before the move is saved. */
+	virtual void ControlledCharacterMove(const FVector& InputVector, float DeltaSeconds) override;
+
+	/** Performs a single move received from the client on the server. */
+	virtual void ServerMove_PerformMovement(const FCharacterNetworkMoveData& MoveData) override;
+
+	/** Receives the packed moves of the client on the server. Holds them in the server move buffer if it is enabled. */
+	virtual void ServerMovePacked_ServerReceive(const FCharacterServerMovePackedBits& PackedBits) override;
+
+	/**
+	 *	Determines how long the client may hold a move before sending it to the server, based on the movement state and ping.
+	 *	The engine already raises it for idle characters and low net speeds.
+	 *	@see HighVelocitySendDeltaTime, StraightLineSendDeltaTime.
+	 */
+	virtual float GetClientNetSendDeltaTime(const APlayerController* PC, const FNetworkPredictionData_Client_Character* ClientData, const FSavedMovePtr& NewMove) const override;
+
+	/**
+	 *	Determines if a move may be held back and combined. Moves that change the compressed flags or the movement mode
+	 *	since the previous move are sent right away, which covers every ability start.
+	 */
+	virtual bool CanDelaySendingMove(const FSavedMovePtr& NewMove) override;
+
+	/** Replays the pending saved moves after a correction from the server. */
+	virtual bool ClientUpdatePositionAfterServerUpdate() override;
+
+	/** Handles the response of the server to a move, used to count the corrections received. */
+	virtual void ClientHandleMoveResponse(const FCharacterMoveResponseDataContainer& MoveResponse) override;
+
+private:
+
+	/** Pending inputs used to measure input-to-ack latency on the MovementPrediction trace channel. */
+	FMovementPredictionTraceState PredictionTraceState;
 	
 #pragma endregion
 
-#pragma region Compressed Flags
-	
+#pragma region Server State
+
+private:
+
+	/** The movement state last sent to or received by the server, used to suppress sends of unchanged values. */
+	FMovementStateDelta LastServerState;
+
+	/** The number of state changes requested since the last flush. */
+	int32 PendingServerStateRequests = 0;
+
+	/** The total number of state RPCs that were suppressed because the value was unchanged or merged into another send. */
+	uint32 SuppressedServerStateRPCs = 0;
+
+	/**
+	 *	Builds the movement state that should currently be on the server.
+	 *	@return the current movement state with every field set.
+	 */
+	FMovementStateDelta MakeServerState() const;
+
+	/** Notes that a replicated movement state value may have changed. The change is sent by the next FlushServerState(). */
+	FORCEINLINE void RequestServerStateSync() { ++PendingServerStateRequests; }
+
+	/** Sends every movement state value that changed since the last flush to the server in a single RPC. Called once per tick. */
+	void FlushServerState();
+
 public:
 
 	/**
-	 *	Sets the direction of the player on the server.
-	 *	@param MoveDir the direction of the player.
+	 *	Applies the changed movement state values on the server and multicasts the ones other clients need.
+	 *	@param Delta the changed values.
 	 */
 	UFUNCTION(Server, Reliable, WithValidation)
-	void ServerSetMoveDirection(const FVector& MoveDir);
+	void ServerSetMovementState(const FMovementStateDelta& Delta);
+
+	/** Returns the total number of state RPCs that were suppressed by coalescing. */
+	FORCEINLINE uint32 GetSuppressedServerStateRPCs() const { return SuppressedServerStateRPCs; }
+
+#pragma endregion
+
+#pragma region Compressed Flags
 	
 private:
 
@@ -740,6 +1523,15 @@ private:
 	
 	/** Compressed flag for requesting to blink. */
 	uint8 bWantsToDodge : 1;
+
+	/** Compressed flag for requesting to slide. */
+	uint8 bWantsToSlide : 1;
+
+	/** Compressed flag for requesting to slide jump. */
+	uint8 bWantsToSlideJump : 1;
+
+	/** Compressed flag set for the move the grapple hook was fired in. */
+	uint8 bWantsToGrapple : 1;
 	
 	/** RPC setting movement direction of player. */
 	FVector MoveDirection;
@@ -750,6 +1542,61 @@ private:
 	
 };
 
+/**
+ *	The custom state of a saved move, packed into a single block so it can be compared with one memcmp and copied with one memcpy.
+ *	Always zero the whole block before writing to it so the unused bits compare equal.
+ */
+struct FSavedMyMovementState
+{
+	/** The movement direction. The component only ever holds quantized directions, so packing it loses nothing. */
+	FQuantizedMoveDirection MoveDirection;
+
+	/** Bit mask of the active movement modifiers. */
+	uint8 MovementModifiers;
+
+	/** Compressed flag for requesting to sprint. */
+	uint8 WantsToSprint : 1;
+
+	/** Compressed flag for requesting to wall run. */
+	uint8 WallRunKeysDown : 1;
+
+	/** Compressed flag for requesting to blink. */
+	uint8 bWantsToDodge : 1;
+
+	/** Compressed flag for requesting to slide. */
+	uint8 bWantsToSlide : 1;
+
+	/** Compressed flag for requesting to slide jump. */
+	uint8 bWantsToSlideJump : 1;
+
+	/** Compressed flag set for the move the grapple hook was fired in. */
+	uint8 bWantsToGrapple : 1;
+
+	/** Whether the stimmy was active, which changes the max speed and acceleration of the move. */
+	uint8 bIsStimmy : 1;
+
+	/** Fixed ticks left until the blink ends, only used by the fixed tick simulation. */
+	uint8 DodgeTicksRemaining;
+
+	/** Fixed ticks since the last slide force, only used by the fixed tick simulation. */
+	uint8 SlideForceTicks;
+
+	bool operator==(const FSavedMyMovementState& Other) const { return FMemory::Memcmp(this, &Other, sizeof(FSavedMyMovementState)) == 0; }
+	bool operator!=(const FSavedMyMovementState& Other) const { return !(*this == Other); }
+
+	/** Compares everything but the fixed tick counters, which advance on every move and would stop moves from being combined. */
+	bool EqualsIgnoringFixedTicks(const FSavedMyMovementState& Other) const
+	{
+		FSavedMyMovementState This = *this;
+		FSavedMyMovementState That = Other;
+		This.DodgeTicksRemaining = That.DodgeTicksRemaining = 0;
+		This.SlideForceTicks = That.SlideForceTicks = 0;
+		return This == That;
+	}
+};
+
+static_assert(sizeof(FSavedMyMovementState) == 8, "FSavedMyMovementState should stay packed into 8 bytes");
+
 class FSavedMove_MyMovement : public FSavedMove_Character
 {
 #pragma region Setup
@@ -778,6 +1625,16 @@ public:
 	 */
 	virtual bool CanCombineWith(const FSavedMovePtr& NewMovePtr, ACharacter* Character, float MaxDelta) const override;
 
+	/** Combines the pending move into this one, only called once the engine has decided to combine them. */
+	virtual void CombineWith(const FSavedMove_Character* OldMove, ACharacter* InCharacter, APlayerController* PC, const FVector& OldStartLocation) override;
+
+	/**
+	 *	Starts this move with the fixed tick counters of an earlier move it was combined with, so the ticks of the earlier move
+	 *	are not counted a second time when the combined move is simulated.
+	 *	@param EarlierMove the move this one was combined with.
+	 */
+	void TakeFixedTicksFrom(const FSavedMove_MyMovement& EarlierMove);
+
 	/** Sets up the move before sending it to the server. */
 	virtual void SetMoveFor(ACharacter* Character, float InDeltaTime, FVector const& NewAccel, class FNetworkPredictionData_Client_Character& ClientData) override;
 
@@ -790,27 +1647,23 @@ public:
 		FLAG_WallRun = 0x08,
 		FLAG_Slide = 0x10,
 		FLAG_3 = 0x20,
-		FLAG_4 = 0x40,
-		FLAG_5 = 0x80,
+		FLAG_SlideJump = 0x40,
+		FLAG_Grapple = 0x80,
 	};
 
 #pragma endregion 
 
 #pragma region Saved Compressed Flags
 	
+public:
+
+	/** @return the saved compressed flags, movement direction and movement modifiers. */
+	FORCEINLINE const FSavedMyMovementState& GetSavedState() const { return SavedState; }
+
 private:
 
-	/** Saved compressed flag for requesting to sprint. */
-	uint8 SavedWantsToSprint : 1;
-	
-	/** Saved compressed flag for requesting to wall run .*/
-	uint8 SavedWallRunKeysDown : 1;
-	
-	/** Saved compressed flag for requesting to blink. */
-	uint8 bSavedWantsToDodge : 1;
-	
-	/** Saved RPC setting movement direction of player. */
-	FVector SavedMoveDirection;
+	/** Saved compressed flags, movement direction and movement modifiers. */
+	FSavedMyMovementState SavedState;
 
 	//bool SavedWantsToJump;
 	
@@ -826,6 +1679,23 @@ public:
 	/** Constructor */
 	FNetworkPredictionData_Client_My(const UCharacterMovementComponent& ClientMovement);
 
-	/** Brief allocates a new copy of our custom saved move. */
+	/** Destructor */
+	virtual ~FNetworkPredictionData_Client_My() override;
+
+	/** Brief hands out a free move from the saved move pool, or allocates a new one if the pool is exhausted. */
 	virtual FSavedMovePtr AllocateNewMove() override;
+
+	/** @return the memory allocated up front for the saved move pool of this client, in bytes. */
+	FORCEINLINE SIZE_T GetSavedMovePoolSize() const { return SavedMovePool.Num() * sizeof(FSavedMove_MyMovement); }
+
+private:
+
+	/**
+	 *	Every saved move this client can have in flight, allocated up front and sized from MaxSavedMoveCount.
+	 *	A pooled move is free again once the engine drops its last reference to it.
+	 */
+	TArray<FSavedMovePtr> SavedMovePool;
+
+	/** The most saved moves that were in use at once, counted from the saved moves and the last acked move. */
+	int32 PeakSavedMovesInUse = 0;
 };
\ No newline at end of file
@@ -0,0 +1,313 @@
+#include "Replication/MyMovementNetSerializers.h"
+
+#if UE_WITH_IRIS
+
+#include "Iris/ReplicationState/PropertyNetSerializerInfoRegistry.h"
+#include "Iris/Serialization/NetBitStreamReader.h"
+#include "Iris/Serialization/NetBitStreamWriter.h"
+#include "Iris/Serialization/NetSerializationContext.h"
+#include "Iris/Serialization/NetSerializerDelegates.h"
+#include "Character/Components/MyCharacterMovementComponent.h"
+
+namespace UE::Net
+{
+
+struct FMyMovementNetStateNetSerializer
+{
+	static constexpr uint32 Version = 0;
+
+	struct FQuantizedType
+	{
+		int32 Anchor[3];
+		int16 Direction[3];
+		uint8 WallRunSide;
+		uint8 ImpulseMovementMode;
+		uint8 ProxyExtrapolationModel;
+		uint8 IsSliding;
+
+		/** Keeps every byte initialized, states are compared with Memcmp. */
+		uint8 Padding[2];
+	};
+
+	typedef FMyMovementNetState SourceType;
+	typedef FQuantizedType QuantizedType;
+	typedef FMyMovementNetStateNetSerializerConfig ConfigType;
+
+	static const ConfigType DefaultConfig;
+
+	static void Serialize(FNetSerializationContext& Context, const FNetSerializeArgs& Args);
+	static void Deserialize(FNetSerializationContext& Context, const FNetDeserializeArgs& Args);
+
+	static void SerializeDelta(FNetSerializationContext& Context, const FNetSerializeDeltaArgs& Args);
+	static void DeserializeDelta(FNetSerializationContext& Context, const FNetDeserializeDeltaArgs& Args);
+
+	static void Quantize(FNetSerializationContext& Context, const FNetQuantizeArgs& Args);
+	static void Dequantize(FNetSerializationContext& Context, const FNetDequantizeArgs& Args);
+
+	static bool IsEqual(FNetSerializationContext& Context, const FNetIsEqualArgs& Args);
+
+private:
+
+	static bool UsesDirection(const QuantizedType& Value) { return Value.ProxyExtrapolationModel == EXTRAPOLATE_WallRun || Value.ProxyExtrapolationModel == EXTRAPOLATE_Slide; }
+	static bool UsesAnchor(const QuantizedType& Value) { return Value.ProxyExtrapolationModel == EXTRAPOLATE_Grapple; }
+
+	static void WriteSigned(FNetBitStreamWriter* Writer, int32 Value, uint32 BitCount) { Writer->WriteBits(static_cast<uint32>(Value) & ((1U << BitCount) - 1U), BitCount); }
+	static int32 ReadSigned(FNetBitStreamReader* Reader, uint32 BitCount) { return static_cast<int32>(Reader->ReadBits(BitCount) << (32U - BitCount)) >> (32U - BitCount); }
+
+	static void WriteDiscrete(FNetBitStreamWriter* Writer, const QuantizedType& Value);
+	static void ReadDiscrete(FNetBitStreamReader* Reader, QuantizedType& Value);
+
+	static void WriteDirection(FNetBitStreamWriter* Writer, const QuantizedType& Value);
+	static void ReadDirection(FNetBitStreamReader* Reader, QuantizedType& Value);
+
+	class FNetSerializerRegistryDelegates final : private UE::Net::FNetSerializerRegistryDelegates
+	{
+	public:
+		virtual ~FNetSerializerRegistryDelegates();
+
+	private:
+		virtual void OnPreFreezeNetSerializerRegistry() override;
+	};
+
+	static FMyMovementNetStateNetSerializer::FNetSerializerRegistryDelegates NetSerializerRegistryDelegates;
+};
+
+static const FName PropertyNetSerializerRegistry_NAME_MyMovementNetState("MyMovementNetState");
+UE_NET_IMPLEMENT_NAMED_STRUCT_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_MyMovementNetState, FMyMovementNetStateNetSerializer);
+
+UE_NET_IMPLEMENT_SERIALIZER(FMyMovementNetStateNetSerializer);
+
+const FMyMovementNetStateNetSerializer::ConfigType FMyMovementNetStateNetSerializer::DefaultConfig;
+FMyMovementNetStateNetSerializer::FNetSerializerRegistryDelegates FMyMovementNetStateNetSerializer::NetSerializerRegistryDelegates;
+
+void FMyMovementNetStateNetSerializer::Serialize(FNetSerializationContext& Context, const FNetSerializeArgs& Args)
+{
+	const QuantizedType& Value = *reinterpret_cast<const QuantizedType*>(Args.Source);
+	const ConfigType* Config = static_cast<const ConfigType*>(Args.NetSerializerConfig);
+	FNetBitStreamWriter* Writer = Context.GetBitStreamWriter();
+
+	WriteDiscrete(Writer, Value);
+
+	if (UsesDirection(Value))
+		WriteDirection(Writer, Value);
+
+	if (UsesAnchor(Value))
+	{
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+			WriteSigned(Writer, Value.Anchor[Axis], Config->AnchorBits);
+	}
+}
+
+void FMyMovementNetStateNetSerializer::Deserialize(FNetSerializationContext& Context, const FNetDeserializeArgs& Args)
+{
+	QuantizedType& Target = *reinterpret_cast<QuantizedType*>(Args.Target);
+	const ConfigType* Config = static_cast<const ConfigType*>(Args.NetSerializerConfig);
+	FNetBitStreamReader* Reader = Context.GetBitStreamReader();
+
+	QuantizedType Value = {};
+	ReadDiscrete(Reader, Value);
+
+	if (UsesDirection(Value))
+		ReadDirection(Reader, Value);
+
+	if (UsesAnchor(Value))
+	{
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+			Value.Anchor[Axis] = ReadSigned(Reader, Config->AnchorBits);
+	}
+
+	Target = Value;
+}
+
+void FMyMovementNetStateNetSerializer::SerializeDelta(FNetSerializationContext& Context, const FNetSerializeDeltaArgs& Args)
+{
+	const QuantizedType& Value = *reinterpret_cast<const QuantizedType*>(Args.Source);
+	const QuantizedType& Prev = *reinterpret_cast<const QuantizedType*>(Args.Prev);
+	const ConfigType* Config = static_cast<const ConfigType*>(Args.NetSerializerConfig);
+	FNetBitStreamWriter* Writer = Context.GetBitStreamWriter();
+
+	// Most of the time nothing changed since the acknowledged state
+	if (Writer->WriteBool(FMemory::Memcmp(&Value, &Prev, sizeof(QuantizedType)) != 0) == false)
+		return;
+
+	const bool bDiscreteChanged = Value.WallRunSide != Prev.WallRunSide || Value.ImpulseMovementMode != Prev.ImpulseMovementMode
+		|| Value.ProxyExtrapolationModel != Prev.ProxyExtrapolationModel || Value.IsSliding != Prev.IsSliding;
+	if (Writer->WriteBool(bDiscreteChanged))
+		WriteDiscrete(Writer, Value);
+
+	if (UsesDirection(Value))
+	{
+		const bool bDirectionChanged = FMemory::Memcmp(Value.Direction, Prev.Direction, sizeof(Value.Direction)) != 0;
+		if (Writer->WriteBool(bDirectionChanged))
+			WriteDirection(Writer, Value);
+	}
+
+	if (UsesAnchor(Value))
+	{
+		const bool bAnchorChanged = FMemory::Memcmp(Value.Anchor, Prev.Anchor, sizeof(Value.Anchor)) != 0;
+		if (Writer->WriteBool(bAnchorChanged))
+		{
+			// A grapple anchor moving with the hook only needs the difference, a new anchor is sent in full
+			const int32 MaxDelta = (1 << (Config->AnchorDeltaBits - 1)) - 1;
+			bool bSmallDelta = true;
+			for (int32 Axis = 0; Axis < 3; ++Axis)
+				bSmallDelta &= FMath::Abs(Value.Anchor[Axis] - Prev.Anchor[Axis]) <= MaxDelta;
+
+			Writer->WriteBool(bSmallDelta);
+			for (int32 Axis = 0; Axis < 3; ++Axis)
+			{
+				if (bSmallDelta)
+					WriteSigned(Writer, Value.Anchor[Axis] - Prev.Anchor[Axis], Config->AnchorDeltaBits);
+				else
+					WriteSigned(Writer, Value.Anchor[Axis], Config->AnchorBits);
+			}
+		}
+	}
+}
+
+void FMyMovementNetStateNetSerializer::DeserializeDelta(FNetSerializationContext& Context, const FNetDeserializeDeltaArgs& Args)
+{
+	QuantizedType& Target = *reinterpret_cast<QuantizedType*>(Args.Target);
+	const QuantizedType& Prev = *reinterpret_cast<const QuantizedType*>(Args.Prev);
+	const ConfigType* Config = static_cast<const ConfigType*>(Args.NetSerializerConfig);
+	FNetBitStreamReader* Reader = Context.GetBitStreamReader();
+
+	QuantizedType Value = Prev;
+	if (!Reader->ReadBool())
+	{
+		Target = Value;
+		return;
+	}
+
+	if (Reader->ReadBool())
+		ReadDiscrete(Reader, Value);
+
+	// Vectors the model doesn't use are zero, like Quantize leaves them
+	if (UsesDirection(Value))
+	{
+		if (Reader->ReadBool())
+			ReadDirection(Reader, Value);
+	}
+	else
+		FMemory::Memzero(Value.Direction);
+
+	if (UsesAnchor(Value))
+	{
+		if (Reader->ReadBool())
+		{
+			const bool bSmallDelta = Reader->ReadBool();
+			for (int32 Axis = 0; Axis < 3; ++Axis)
+				Value.Anchor[Axis] = bSmallDelta ? Prev.Anchor[Axis] + ReadSigned(Reader, Config->AnchorDeltaBits) : ReadSigned(Reader, Config->AnchorBits);
+		}
+	}
+	else
+		FMemory::Memzero(Value.Anchor);
+
+	Target = Value;
+}
+
+void FMyMovementNetStateNetSerializer::Quantize(FNetSerializationContext& Context, const FNetQuantizeArgs& Args)
+{
+	const SourceType& Source = *reinterpret_cast<const SourceType*>(Args.Source);
+	QuantizedType& Target = *reinterpret_cast<QuantizedType*>(Args.Target);
+	const ConfigType* Config = static_cast<const ConfigType*>(Args.NetSerializerConfig);
+
+	QuantizedType Value = {};
+	Value.WallRunSide = Source.WallRunSide & 0x03;
+	Value.ImpulseMovementMode = Source.ImpulseMovementMode;
+	Value.ProxyExtrapolationModel = Source.ProxyExtrapolationModel & 0x07;
+	Value.IsSliding = Source.IsSliding ? 1 : 0;
+
+	// Unused vectors are quantized to zero so they never make two states differ
+	if (Source.UsesExtrapolationDirection())
+	{
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+			Value.Direction[Axis] = static_cast<int16>(FMath::RoundToInt(FMath::Clamp(Source.ProxyExtrapolationDirection[Axis], -1.0, 1.0) * MAX_int16));
+	}
+
+	if (Source.UsesExtrapolationAnchor())
+	{
+		const int32 MaxAnchor = (1 << (Config->AnchorBits - 1)) - 1;
+		for (int32 Axis = 0; Axis < 3; ++Axis)
+			Value.Anchor[Axis] = FMath::Clamp(FMath::RoundToInt(Source.ProxyExtrapolationAnchor[Axis]), -MaxAnchor, MaxAnchor);
+	}
+
+	Target = Value;
+}
+
+void FMyMovementNetStateNetSerializer::Dequantize(FNetSerializationContext& Context, const FNetDequantizeArgs& Args)
+{
+	const QuantizedType& Source = *reinterpret_cast<const QuantizedType*>(Args.Source);
+	SourceType& Target = *reinterpret_cast<SourceType*>(Args.Target);
+
+	Target.WallRunSide = Source.WallRunSide;
+	Target.ImpulseMovementMode = Source.ImpulseMovementMode;
+	Target.ProxyExtrapolationModel = Source.ProxyExtrapolationModel;
+	Target.IsSliding = Source.IsSliding != 0;
+	Target.ProxyExtrapolationDirection = FVector(Source.Direction[0], Source.Direction[1], Source.Direction[2]) / MAX_int16;
+	Target.ProxyExtrapolationAnchor = FVector(Source.Anchor[0], Source.Anchor[1], Source.Anchor[2]);
+}
+
+bool FMyMovementNetStateNetSerializer::IsEqual(FNetSerializationContext& Context, const FNetIsEqualArgs& Args)
+{
+	if (Args.bStateIsQuantized)
+		return FMemory::Memcmp(reinterpret_cast<const void*>(Args.Source0), reinterpret_cast<const void*>(Args.Source1), sizeof(QuantizedType)) == 0;
+
+	// Compare what would be sent, changes below the quantization are not worth replicating
+	QuantizedType Value0;
+	QuantizedType Value1;
+
+	FNetQuantizeArgs QuantizeArgs = {};
+	QuantizeArgs.NetSerializerConfig = Args.NetSerializerConfig;
+	QuantizeArgs.Source = Args.Source0;
+	QuantizeArgs.Target = NetSerializerValuePointer(&Value0);
+	Quantize(Context, QuantizeArgs);
+
+	QuantizeArgs.Source = Args.Source1;
+	QuantizeArgs.Target = NetSerializerValuePointer(&Value1);
+	Quantize(Context, QuantizeArgs);
+
+	return FMemory::Memcmp(&Value0, &Value1, sizeof(QuantizedType)) == 0;
+}
+
+void FMyMovementNetStateNetSerializer::WriteDiscrete(FNetBitStreamWriter* Writer, const QuantizedType& Value)
+{
+	Writer->WriteBits(Value.ProxyExtrapolationModel, 3);
+	Writer->WriteBits(Value.IsSliding, 1);
+	Writer->WriteBits(Value.WallRunSide, 2);
+	Writer->WriteBits(Value.ImpulseMovementMode, 8);
+}
+
+void FMyMovementNetStateNetSerializer::ReadDiscrete(FNetBitStreamReader* Reader, QuantizedType& Value)
+{
+	Value.ProxyExtrapolationModel = static_cast<uint8>(Reader->ReadBits(3));
+	Value.IsSliding = static_cast<uint8>(Reader->ReadBits(1));
+	Value.WallRunSide = static_cast<uint8>(Reader->ReadBits(2));
+	Value.ImpulseMovementMode = static_cast<uint8>(Reader->ReadBits(8));
+}
+
+void FMyMovementNetStateNetSerializer::WriteDirection(FNetBitStreamWriter* Writer, const QuantizedType& Value)
+{
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+		WriteSigned(Writer, Value.Direction[Axis], 16);
+}
+
+void FMyMovementNetStateNetSerializer::ReadDirection(FNetBitStreamReader* Reader, QuantizedType& Value)
+{
+	for (int32 Axis = 0; Axis < 3; ++Axis)
+		Value.Direction[Axis] = static_cast<int16>(ReadSigned(Reader, 16));
+}
+
+FMyMovementNetStateNetSerializer::FNetSerializerRegistryDelegates::~FNetSerializerRegistryDelegates()
+{
+	UE_NET_UNREGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_MyMovementNetState);
+}
+
+void FMyMovementNetStateNetSerializer::FNetSerializerRegistryDelegates::OnPreFreezeNetSerializerRegistry()
+{
+	UE_NET_REGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_MyMovementNetState);
+}
+
+}
+
+#endif
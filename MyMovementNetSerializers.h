@@ -0,0 +1,33 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Iris/Serialization/NetSerializer.h"
+#include "MyMovementNetSerializers.generated.h"
+
+/**
+ *	Config of FMyMovementNetStateNetSerializer, the Iris serializer of FMyMovementNetState.
+ *	The anchor is quantized to whole units within AnchorBits signed bits per component, enough for +-10 km with the default.
+ *	Delta compressed anchors that moved less than 2^(AnchorDeltaBits - 1) units per component only send the difference.
+ */
+USTRUCT()
+struct FMyMovementNetStateNetSerializerConfig : public FNetSerializerConfig
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	uint8 AnchorBits = 21;
+
+	UPROPERTY()
+	uint8 AnchorDeltaBits = 10;
+};
+
+namespace UE::Net
+{
+	/**
+	 *	Iris serializer of FMyMovementNetState, replaces its NetSerialize when replicating with Iris.
+	 *	The discrete state takes 14 bits, the extrapolation direction 16 bits per component and the anchor AnchorBits per component,
+	 *	and the vectors are only sent for the extrapolation models that use them. Delta compression against the last acknowledged
+	 *	state sends a single bit for an unchanged state, and only the changed parts otherwise.
+	 */
+	UE_NET_DECLARE_SERIALIZER(FMyMovementNetStateNetSerializer, IMPULSE_API);
+}
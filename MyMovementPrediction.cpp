@@ -0,0 +1,462 @@
+#include "Character/Components/MyMovementPrediction.h"
+
+#include "Components/CapsuleComponent.h"
+#include "Engine/NetSerialization.h"
+#include "Engine/World.h"
+#include "NetworkPredictionModelDefRegistry.h"
+#include "UObject/CoreNet.h"
+#include "Character/Components/MyCharacterMovementComponent.h"
+#include "Character/Components/MyMovementPredictionComponent.h"
+#include "Character/Components/MyMovementTuning.h"
+
+DECLARE_CYCLE_STAT(TEXT("Prediction Simulation Tick"), STAT_MyMovement_PredictionSimulationTick, STATGROUP_MyCharacterMovement);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Prediction Reconciles"), STAT_MyMovement_PredictionReconciles, STATGROUP_MyCharacterMovement);
+
+NP_MODEL_REGISTER(FMyMovementModelDef);
+
+static int32 SecondsToMS(const float Seconds)
+{
+	return FMath::RoundToInt(Seconds * 1000.f);
+}
+
+#pragma region struct FMyMovementInputCmd
+
+void FMyMovementInputCmd::NetSerialize(const FNetSerializeParams& P)
+{
+	SerializeFixedVector<1, 16>(MovementInput, P.Ar);
+	ControlRotation.SerializeCompressedShort(P.Ar);
+	P.Ar << Buttons;
+}
+
+void FMyMovementInputCmd::Quantize()
+{
+	FNetBitWriter Writer(nullptr, 128);
+	SerializeFixedVector<1, 16>(MovementInput, Writer);
+	ControlRotation.SerializeCompressedShort(Writer);
+
+	FNetBitReader Reader(nullptr, Writer.GetData(), Writer.GetNumBits());
+	SerializeFixedVector<1, 16>(MovementInput, Reader);
+	ControlRotation.SerializeCompressedShort(Reader);
+}
+
+void FMyMovementInputCmd::ToString(FAnsiStringBuilderBase& Out) const
+{
+	Out.Appendf("MovementInput: X=%.2f Y=%.2f Z=%.2f\n", MovementInput.X, MovementInput.Y, MovementInput.Z);
+	Out.Appendf("ControlRotation: P=%.2f Y=%.2f R=%.2f\n", ControlRotation.Pitch, ControlRotation.Yaw, ControlRotation.Roll);
+	Out.Appendf("Buttons: 0x%02x\n", Buttons);
+}
+
+void FMyMovementInputCmd::Interpolate(const FMyMovementInputCmd* From, const FMyMovementInputCmd* To, float PCT)
+{
+	*this = *To;
+}
+
+#pragma endregion
+
+#pragma region struct FMyMovementSyncState
+
+void FMyMovementSyncState::NetSerialize(const FNetSerializeParams& P)
+{
+	// Same precision the character movement replicates with, ShouldReconcile tolerates the rounding
+	SerializePackedVector<100, 30>(Location, P.Ar);
+	SerializePackedVector<10, 24>(Velocity, P.Ar);
+	Rotation.SerializeCompressedShort(P.Ar);
+	P.Ar << MovementModifiers;
+	P.Ar << StateFlags;
+	P.Ar << HeldButtons;
+
+	// The flags are serialized first so both sides know which of these are in use
+	if (HasState(PREDICTED_WallRunning))
+		SerializeFixedVector<1, 16>(WallNormal, P.Ar);
+
+	if (HasModifier(MODIFIER_Grapple))
+		P.Ar << GrappleAnchor;
+
+	// The timers are mostly zero, packed they cost a byte each
+	auto SerializeTime = [&P](int32& TimeMS)
+	{
+		uint32 Value = static_cast<uint32>(TimeMS);
+		P.Ar.SerializeIntPacked(Value);
+		TimeMS = static_cast<int32>(Value);
+	};
+
+	SerializeTime(BlinkTimeMS);
+	SerializeTime(StimmyTimeMS);
+	SerializeTime(BlinkCooldownMS);
+	SerializeTime(StimmyCooldownMS);
+	SerializeTime(SlideJumpCooldownMS);
+	SerializeTime(GrappleCooldownMS);
+}
+
+void FMyMovementSyncState::ToString(FAnsiStringBuilderBase& Out) const
+{
+	Out.Appendf("Location: X=%.2f Y=%.2f Z=%.2f\n", Location.X, Location.Y, Location.Z);
+	Out.Appendf("Velocity: X=%.2f Y=%.2f Z=%.2f\n", Velocity.X, Velocity.Y, Velocity.Z);
+	Out.Appendf("Rotation: P=%.2f Y=%.2f R=%.2f\n", Rotation.Pitch, Rotation.Yaw, Rotation.Roll);
+	Out.Appendf("MovementModifiers: 0x%02x StateFlags: 0x%02x HeldButtons: 0x%02x\n", MovementModifiers, StateFlags, HeldButtons);
+	Out.Appendf("Blink: %d ms (cooldown %d ms) Stimmy: %d ms (cooldown %d ms)\n", BlinkTimeMS, BlinkCooldownMS, StimmyTimeMS, StimmyCooldownMS);
+	Out.Appendf("SlideJump cooldown: %d ms Grapple cooldown: %d ms\n", SlideJumpCooldownMS, GrappleCooldownMS);
+}
+
+void FMyMovementSyncState::Interpolate(const FMyMovementSyncState* From, const FMyMovementSyncState* To, float PCT)
+{
+	// The discrete state snaps to the newer frame, only the transform is blended
+	*this = *To;
+	Location = FMath::Lerp(From->Location, To->Location, PCT);
+	Velocity = FMath::Lerp(From->Velocity, To->Velocity, PCT);
+	Rotation = FMath::Lerp(From->Rotation, To->Rotation, PCT);
+}
+
+bool FMyMovementSyncState::ShouldReconcile(const FMyMovementSyncState& AuthorityState) const
+{
+	// Quantized values are compared with a tolerance, everything else has to match exactly
+	const bool bShouldReconcile = FVector::DistSquared(Location, AuthorityState.Location) > FMath::Square(1.f)
+		|| FVector::DistSquared(Velocity, AuthorityState.Velocity) > FMath::Square(5.f)
+		|| MovementModifiers != AuthorityState.MovementModifiers
+		|| StateFlags != AuthorityState.StateFlags
+		|| BlinkTimeMS != AuthorityState.BlinkTimeMS
+		|| StimmyTimeMS != AuthorityState.StimmyTimeMS
+		|| BlinkCooldownMS != AuthorityState.BlinkCooldownMS
+		|| StimmyCooldownMS != AuthorityState.StimmyCooldownMS
+		|| SlideJumpCooldownMS != AuthorityState.SlideJumpCooldownMS
+		|| GrappleCooldownMS != AuthorityState.GrappleCooldownMS
+		|| (HasModifier(MODIFIER_Grapple) && FVector::DistSquared(GrappleAnchor, AuthorityState.GrappleAnchor) > FMath::Square(1.f));
+
+	if (bShouldReconcile)
+		INC_DWORD_STAT(STAT_MyMovement_PredictionReconciles);
+
+	return bShouldReconcile;
+}
+
+#pragma endregion
+
+#pragma region struct FMyMovementAuxState
+
+void FMyMovementAuxState::NetSerialize(const FNetSerializeParams& P)
+{
+	P.Ar << Mass;
+	P.Ar << SpeedMultiplier;
+}
+
+void FMyMovementAuxState::ToString(FAnsiStringBuilderBase& Out) const
+{
+	Out.Appendf("Mass: %.2f SpeedMultiplier: %.2f\n", Mass, SpeedMultiplier);
+}
+
+void FMyMovementAuxState::Interpolate(const FMyMovementAuxState* From, const FMyMovementAuxState* To, float PCT)
+{
+	*this = *To;
+}
+
+bool FMyMovementAuxState::ShouldReconcile(const FMyMovementAuxState& AuthorityState) const
+{
+	return Mass != AuthorityState.Mass || SpeedMultiplier != AuthorityState.SpeedMultiplier;
+}
+
+#pragma endregion
+
+#pragma region class FMyMovementSimulation
+
+FMyMovementSimulation::FMyMovementSimulation(UCapsuleComponent* InUpdatedComponent, const UMyMovementTuning* InTuning)
+	: UpdatedComponent(InUpdatedComponent)
+	, Tuning(InTuning)
+{
+}
+
+void FMyMovementSimulation::SimulationTick(const FNetSimTimeStep& TimeStep, const TNetSimInput<FMyMovementStateTypes>& Input, const TNetSimOutput<FMyMovementStateTypes>& Output)
+{
+	SCOPE_CYCLE_COUNTER(STAT_MyMovement_PredictionSimulationTick);
+
+	const FMyMovementInputCmd& Cmd = *Input.Cmd;
+	const FMyMovementAuxState& Aux = *Input.Aux;
+	FMyMovementSyncState& Sync = *Output.Sync;
+	Sync = *Input.Sync;
+
+	const float DeltaSeconds = TimeStep.StepMS * 0.001f;
+	const float GravityZ = UpdatedComponent->GetWorld()->GetGravityZ();
+	const uint8 Pressed = Cmd.Buttons & ~Sync.HeldButtons;
+	Sync.HeldButtons = Cmd.Buttons;
+	Sync.Rotation = FRotator(0.f, Cmd.ControlRotation.Yaw, 0.f);
+
+	// Resimulated frames start where the corrected frame started, not where the capsule was left
+	if (UpdatedComponent->GetComponentLocation() != Sync.Location)
+		UpdatedComponent->SetWorldLocationAndRotation(Sync.Location, Sync.Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+
+	const FVector Forward = Sync.Rotation.Vector();
+	const FVector Right = FRotationMatrix(Sync.Rotation).GetScaledAxis(EAxis::Y);
+	const FVector MovementInput = FVector(Cmd.MovementInput.X, Cmd.MovementInput.Y, 0.f).GetClampedToMaxSize(1.f);
+
+	// Count the abilities down in simulation time, so a resimulated frame ends them on the same frame
+	auto CountDown = [&TimeStep](int32& TimeMS)
+	{
+		TimeMS = FMath::Max(TimeMS - TimeStep.StepMS, 0);
+	};
+
+	CountDown(Sync.BlinkCooldownMS);
+	CountDown(Sync.StimmyCooldownMS);
+	CountDown(Sync.SlideJumpCooldownMS);
+	CountDown(Sync.GrappleCooldownMS);
+
+	if (Sync.HasModifier(MODIFIER_Dodge))
+	{
+		CountDown(Sync.BlinkTimeMS);
+		if (Sync.BlinkTimeMS == 0)
+		{
+			Sync.Velocity = FVector::ZeroVector;
+			Sync.RemoveModifier(MODIFIER_Dodge);
+			Sync.BlinkCooldownMS = SecondsToMS(Tuning->BlinkCooldown);
+		}
+	}
+
+	if (Sync.HasState(PREDICTED_Stimmy))
+	{
+		CountDown(Sync.StimmyTimeMS);
+		if (Sync.StimmyTimeMS == 0)
+		{
+			Sync.SetState(PREDICTED_Stimmy, false);
+			Sync.StimmyCooldownMS = SecondsToMS(Tuning->StimmyCooldown);
+		}
+	}
+	else if ((Pressed & BUTTON_Stimmy) && Sync.StimmyCooldownMS == 0)
+	{
+		Sync.SetState(PREDICTED_Stimmy, true);
+		Sync.StimmyTimeMS = SecondsToMS(Tuning->StimmyDuration);
+	}
+
+	const bool bStimmy = Sync.HasState(PREDICTED_Stimmy);
+
+	// The grapple pulls the character off the floor
+	FHitResult FloorHit;
+	bool bOnGround = Sync.Velocity.Z <= 0.f && !Sync.HasModifier(MODIFIER_Grapple) && FindFloor(UCharacterMovementComponent::MAX_FLOOR_DIST, FloorHit);
+	if (bOnGround && !Sync.HasState(PREDICTED_OnGround))
+	{
+		Sync.RemoveModifier(MODIFIER_SlideJump);
+		Sync.SetState(PREDICTED_WallRunning, false);
+	}
+
+	// Jumping
+	if ((Pressed & BUTTON_Jump) && bOnGround)
+	{
+		if (Sync.HasModifier(MODIFIER_Slide) && Sync.SlideJumpCooldownMS == 0)
+		{
+			FVector SlideJumpVelocity = MovementInput.GetSafeNormal2D() * Tuning->HorizontalSlideJumpForce;
+			SlideJumpVelocity.Z = Tuning->VerticalSlideJumpForce;
+			Sync.Velocity = SlideJumpVelocity;
+			Sync.AddModifier(MODIFIER_SlideJump);
+			Sync.SlideJumpCooldownMS = SecondsToMS(Tuning->SlideJumpCooldown);
+		}
+		else
+			Sync.Velocity.Z = Tuning->DefaultJumpZVelocity;
+
+		bOnGround = false;
+	}
+
+	Sync.SetState(PREDICTED_OnGround, bOnGround);
+
+	// Blink
+	if ((Pressed & BUTTON_Blink) && Sync.BlinkCooldownMS == 0 && !Sync.HasModifier(MODIFIER_Dodge))
+	{
+		Sync.Velocity = MovementInput.GetSafeNormal2D() * Tuning->BlinkStrength;
+		Sync.AddModifier(MODIFIER_Dodge);
+		Sync.BlinkTimeMS = SecondsToMS(Tuning->BlinkDuration);
+	}
+
+	// Grapple hook
+	if (Sync.HasModifier(MODIFIER_Grapple))
+	{
+		const FVector ToAnchor = Sync.GrappleAnchor - Sync.Location;
+		Sync.Velocity += ToAnchor.GetSafeNormal() * (Tuning->GrapplePullForce / Aux.Mass) * DeltaSeconds;
+
+		// Release once the anchor is reached or passed, like the grapple hook actor does
+		if (ToAnchor.Size() < Tuning->GrappleReleaseDistance || FVector::DotProduct(ToAnchor.GetSafeNormal2D(), Sync.Velocity.GetSafeNormal2D()) < 0.f)
+		{
+			Sync.RemoveModifier(MODIFIER_Grapple);
+			Sync.GrappleCooldownMS = SecondsToMS(Tuning->GrappleCooldown);
+		}
+	}
+	else if ((Pressed & BUTTON_Grapple) && Sync.GrappleCooldownMS == 0)
+	{
+		FHitResult Hit;
+		const FVector TraceEnd = Sync.Location + Cmd.ControlRotation.Vector() * Tuning->GrappleDistance;
+		const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(MyMovementGrapple), false, UpdatedComponent->GetOwner());
+
+		if (UpdatedComponent->GetWorld()->LineTraceSingleByChannel(Hit, Sync.Location, TraceEnd, ECC_Visibility, QueryParams))
+		{
+			Sync.GrappleAnchor = Hit.ImpactPoint;
+			Sync.Velocity = (Hit.ImpactPoint - Sync.Location).GetSafeNormal() * Tuning->InstantaneousVelocityFromGrapple;
+			Sync.AddModifier(MODIFIER_Grapple);
+			Sync.SetState(PREDICTED_WallRunning, false);
+		}
+	}
+
+	// Wall running
+	if (Sync.HasState(PREDICTED_WallRunning))
+	{
+		if (!(Cmd.Buttons & BUTTON_WallRun) || (Pressed & BUTTON_Jump))
+		{
+			// Jump off of the wall, overriding the vertical velocity like WallRunJump
+			Sync.SetState(PREDICTED_WallRunning, false);
+			Sync.Velocity += FVector(Sync.WallNormal.X, Sync.WallNormal.Y, 0.f) * Tuning->HorizontalWallJumpOffForce;
+			Sync.Velocity.Z = Tuning->VerticalWallJumpOffForce;
+		}
+		else if (!IsNextToWall(Sync.WallNormal))
+			Sync.SetState(PREDICTED_WallRunning, false);
+	}
+	else if (!bOnGround && (Cmd.Buttons & BUTTON_WallRun) && !Sync.HasModifier(MODIFIER_Grapple))
+	{
+		FHitResult WallHit;
+		if (FindWall(Right, WallHit))
+		{
+			Sync.WallNormal = WallHit.ImpactNormal;
+			Sync.SetState(PREDICTED_WallRunning, true);
+			Sync.SetState(PREDICTED_WallRunRight, FVector2D::DotProduct(FVector2D(WallHit.ImpactNormal), FVector2D(Right)) > 0.0);
+		}
+	}
+
+	// Sliding
+	if (Sync.HasModifier(MODIFIER_Slide))
+	{
+		if (!bOnGround || !(Cmd.Buttons & BUTTON_Slide) || Sync.Velocity.Size2D() < Tuning->DefaultMaxWalkSpeedCrouched)
+			Sync.RemoveModifier(MODIFIER_Slide);
+	}
+	else if (bOnGround && (Pressed & BUTTON_Slide) && FVector::DotProduct(Sync.Velocity.GetSafeNormal2D(), Forward) > 0.5f)
+		Sync.AddModifier(MODIFIER_Slide);
+
+	const bool bSliding = Sync.HasModifier(MODIFIER_Slide);
+	Sync.SetState(PREDICTED_Sprinting, bOnGround && !bSliding && (Cmd.Buttons & BUTTON_Sprint) && FVector::DotProduct(MovementInput, Forward) > 0.5f);
+
+	// Velocity
+	if (Sync.HasState(PREDICTED_WallRunning))
+	{
+		const FVector CrossVector = Sync.HasState(PREDICTED_WallRunRight) ? FVector(0.0f, 0.0f, 1.0f) : FVector(0.0f, 0.0f, -1.0f);
+		const FVector WallRunDirection = FVector::CrossProduct(Sync.WallNormal, CrossVector);
+		const float WallRunSpeed = Tuning->GetMaxSpeed(SPEED_WallRun, bStimmy) * Aux.SpeedMultiplier;
+		Sync.Velocity = FVector(WallRunDirection.X * WallRunSpeed, WallRunDirection.Y * WallRunSpeed, 0.f);
+	}
+	else if (bOnGround)
+	{
+		const EMovementSpeedState SpeedState = bSliding ? SPEED_Slide : Sync.HasState(PREDICTED_Sprinting) ? SPEED_Sprint : SPEED_Run;
+
+		// The blink and the slide remove the ground friction, like their movement modifiers
+		const bool bFrictionless = bSliding || Sync.HasModifier(MODIFIER_Dodge);
+		CalcVelocity(Sync, MovementInput, Tuning->GetMaxSpeed(SpeedState, bStimmy) * Aux.SpeedMultiplier, Tuning->GetMaxAcceleration(SpeedState, bStimmy),
+			bFrictionless ? 0.f : Tuning->DefaultGroundFriction, bFrictionless ? 0.f : Tuning->DefaultBrakingDecelerationWalking, DeltaSeconds);
+
+		// Slides are accelerated down the slope of the floor
+		if (bSliding)
+			Sync.Velocity += FVector::VectorPlaneProject(FVector(0.f, 0.f, GravityZ), FloorHit.ImpactNormal) * DeltaSeconds;
+
+		Sync.Velocity.Z = 0.f;
+	}
+	else
+	{
+		const float GravityScale = Sync.HasModifier(MODIFIER_Grapple) ? 0.f : Sync.HasModifier(MODIFIER_SlideJump) ? Tuning->SlideJumpGravityScale : Tuning->DefaultGravityScale;
+		Sync.Velocity.Z += GravityZ * GravityScale * DeltaSeconds;
+
+		const EMovementSpeedState SpeedState = Sync.HasState(PREDICTED_Sprinting) ? SPEED_Sprint : SPEED_Run;
+		CalcVelocity(Sync, MovementInput * Tuning->DefaultAirControl, Tuning->GetMaxSpeed(SpeedState, bStimmy) * Aux.SpeedMultiplier, Tuning->GetMaxAcceleration(SpeedState, bStimmy),
+			Tuning->DefaultFallingLateralFriction, 0.f, DeltaSeconds);
+	}
+
+	MoveWithCollision(Sync, DeltaSeconds, bOnGround);
+}
+
+bool FMyMovementSimulation::FindFloor(const float MaxDistance, FHitResult& OutHit) const
+{
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(MyMovementFindFloor), false, UpdatedComponent->GetOwner());
+	FCollisionResponseParams ResponseParams;
+	UpdatedComponent->InitSweepCollisionParams(QueryParams, ResponseParams);
+
+	const FVector Start = UpdatedComponent->GetComponentLocation();
+	const FVector End = Start - FVector(0.f, 0.f, MaxDistance);
+
+	if (!UpdatedComponent->GetWorld()->SweepSingleByChannel(OutHit, Start, End, FQuat::Identity, UpdatedComponent->GetCollisionObjectType(),
+		UpdatedComponent->GetCollisionShape(), QueryParams, ResponseParams))
+	{
+		return false;
+	}
+
+	return !OutHit.bStartPenetrating && OutHit.ImpactNormal.Z >= Tuning->DefaultWalkableFloorZ;
+}
+
+bool FMyMovementSimulation::FindWall(const FVector& Right, FHitResult& OutHit) const
+{
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(MyMovementFindWall), false, UpdatedComponent->GetOwner());
+	const FVector Start = UpdatedComponent->GetComponentLocation();
+
+	// Same reach and surface angles as the wall run of UMyCharacterMovementComponent
+	for (const float Side : { 1.f, -1.f })
+	{
+		if (!UpdatedComponent->GetWorld()->LineTraceSingleByChannel(OutHit, Start, Start + Right * Side * Tuning->WallRunTraceReach, ECC_Visibility, QueryParams))
+			continue;
+
+		if (OutHit.ImpactNormal.Z >= -0.05f && OutHit.ImpactNormal.Z < Tuning->DefaultWalkableFloorZ)
+			return true;
+	}
+
+	return false;
+}
+
+bool FMyMovementSimulation::IsNextToWall(const FVector& WallNormal) const
+{
+	const FVector Start = UpdatedComponent->GetComponentLocation();
+	const FVector End = Start - FVector(WallNormal.X, WallNormal.Y, 0.f).GetSafeNormal() * Tuning->WallRunTraceReach;
+
+	return UMyCharacterMovementComponent::TraceNextToWall(UpdatedComponent->GetWorld(), Start, End, Tuning->LineTraceVerticalTolerance);
+}
+
+void FMyMovementSimulation::CalcVelocity(FMyMovementSyncState& Sync, const FVector& MovementInput, const float MaxSpeed, const float MaxAcceleration,
+	const float Friction, const float BrakingDeceleration, const float DeltaSeconds)
+{
+	// Only the lateral velocity is accelerated, the vertical velocity is left to gravity and the abilities
+	FVector Velocity2D(Sync.Velocity.X, Sync.Velocity.Y, 0.f);
+	const float Speed = Velocity2D.Size();
+
+	if (MovementInput.IsNearlyZero())
+	{
+		// Brake without ever reversing the velocity
+		const FVector Braking = -(Velocity2D * Friction + Velocity2D.GetSafeNormal() * BrakingDeceleration) * DeltaSeconds;
+		Velocity2D = Braking.SizeSquared() >= Velocity2D.SizeSquared() ? FVector::ZeroVector : Velocity2D + Braking;
+	}
+	else
+	{
+		const float InputMaxSpeed = MaxSpeed * MovementInput.Size();
+		const bool bExceedingMaxSpeed = Speed > InputMaxSpeed;
+
+		// Friction turns the velocity towards the input, like UCharacterMovementComponent::CalcVelocity
+		Velocity2D -= (Velocity2D - MovementInput.GetSafeNormal() * Speed) * FMath::Min(DeltaSeconds * Friction, 1.f);
+		Velocity2D += MovementInput * MaxAcceleration * DeltaSeconds;
+
+		// Speed gained from the abilities is kept, the input alone never accelerates past the maximum
+		Velocity2D = Velocity2D.GetClampedToMaxSize(bExceedingMaxSpeed ? Speed : InputMaxSpeed);
+	}
+
+	Sync.Velocity = FVector(Velocity2D.X, Velocity2D.Y, Sync.Velocity.Z);
+}
+
+void FMyMovementSimulation::MoveWithCollision(FMyMovementSyncState& Sync, const float DeltaSeconds, const bool bSnapToFloor) const
+{
+	FVector Delta = Sync.Velocity * DeltaSeconds;
+	const FQuat Rotation = Sync.Rotation.Quaternion();
+
+	for (int32 Iteration = 0; Iteration < 3 && !Delta.IsNearlyZero(); ++Iteration)
+	{
+		FHitResult Hit(1.f);
+		UpdatedComponent->MoveComponent(Delta, Rotation, true, &Hit);
+		if (!Hit.IsValidBlockingHit())
+			break;
+
+		// Slide along whatever was hit with the rest of the move
+		Delta = FVector::VectorPlaneProject(Delta * (1.f - Hit.Time), Hit.Normal);
+		Sync.Velocity = FVector::VectorPlaneProject(Sync.Velocity, Hit.Normal);
+	}
+
+	// Stay on the floor when walking down slopes and steps, up to the max step height
+	FHitResult FloorHit;
+	if (bSnapToFloor && FindFloor(Tuning->DefaultMaxStepHeight, FloorHit))
+		UpdatedComponent->SetWorldLocation(FloorHit.Location);
+
+	Sync.Location = UpdatedComponent->GetComponentLocation();
+}
+
+#pragma endregion
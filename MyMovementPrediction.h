@@ -0,0 +1,249 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NetworkPredictionModelDef.h"
+#include "NetworkPredictionReplicationProxy.h"
+#include "NetworkPredictionSimulation.h"
+#include "NetworkPredictionStateTypes.h"
+#include "NetworkPredictionTickState.h"
+
+class UCapsuleComponent;
+class UMyMovementTuning;
+class UMyMovementPredictionComponent;
+
+/**
+ *	The buttons of the abilities, one bit each in FMyMovementInputCmd::Buttons.
+ *	BUTTON_Jump - jump, wall jump while wall running and slide jump while sliding.
+ *	BUTTON_Sprint - sprint while held.
+ *	BUTTON_WallRun - the keys required to start and keep wall running.
+ *	BUTTON_Slide - slide while held.
+ *	BUTTON_Blink - blink in the direction of the movement input.
+ *	BUTTON_Stimmy - start the stimmy.
+ *	BUTTON_Grapple - fire the grapple hook along the aim.
+ */
+enum EPredictedMovementButton : uint8
+{
+	BUTTON_Jump = 1 << 0,
+	BUTTON_Sprint = 1 << 1,
+	BUTTON_WallRun = 1 << 2,
+	BUTTON_Slide = 1 << 3,
+	BUTTON_Blink = 1 << 4,
+	BUTTON_Stimmy = 1 << 5,
+	BUTTON_Grapple = 1 << 6,
+};
+
+/**
+ *	The discrete state of the simulation, one bit each in FMyMovementSyncState::StateFlags.
+ *	Blink, slide, slide jump and grapple are tracked by their EMovementModifier bits instead.
+ *	PREDICTED_OnGround - standing on a walkable floor.
+ *	PREDICTED_Sprinting - sprinting on the ground.
+ *	PREDICTED_WallRunning - running along a wall.
+ *	PREDICTED_WallRunRight - the wall run side is kRight instead of kLeft, only meaningful while wall running.
+ *	PREDICTED_Stimmy - the stimmy is active.
+ */
+enum EPredictedMovementState : uint8
+{
+	PREDICTED_OnGround = 1 << 0,
+	PREDICTED_Sprinting = 1 << 1,
+	PREDICTED_WallRunning = 1 << 2,
+	PREDICTED_WallRunRight = 1 << 3,
+	PREDICTED_Stimmy = 1 << 4,
+};
+
+/** The input produced by the controlling player for a single simulation frame. */
+struct FMyMovementInputCmd
+{
+	/** The movement input in world space, at most one unit long. */
+	FVector MovementInput = FVector::ZeroVector;
+
+	/** The control rotation, used for the facing of the character and the aim of the grapple. */
+	FRotator ControlRotation = FRotator::ZeroRotator;
+
+	/** Bit mask of the held EPredictedMovementButton. */
+	uint8 Buttons = 0;
+
+	void NetSerialize(const FNetSerializeParams& P);
+
+	/**
+	 *	Rounds the movement input and the control rotation to the precision NetSerialize sends them with,
+	 *	so the client simulates the same command the server receives.
+	 */
+	void Quantize();
+
+	void ToString(FAnsiStringBuilderBase& Out) const;
+
+	void Interpolate(const FMyMovementInputCmd* From, const FMyMovementInputCmd* To, float PCT);
+};
+
+/**
+ *	Everything the simulation changes every frame. Replaces the compressed flags, the state RPCs and the ability timers
+ *	of UMyCharacterMovementComponent, the timers count down in simulation time so rollbacks reproduce them.
+ */
+struct FMyMovementSyncState
+{
+	FVector Location = FVector::ZeroVector;
+
+	FVector Velocity = FVector::ZeroVector;
+
+	FRotator Rotation = FRotator::ZeroRotator;
+
+	/** The normal of the wall being ran on, only serialized while wall running. */
+	FVector WallNormal = FVector::ZeroVector;
+
+	/** Where the grapple hook is attached, only serialized while grappling. */
+	FVector GrappleAnchor = FVector::ZeroVector;
+
+	/** Bit mask of the active EMovementModifier. */
+	uint8 MovementModifiers = 0;
+
+	/** Bit mask of EPredictedMovementState. */
+	uint8 StateFlags = 0;
+
+	/** The buttons held during the last frame, used to only trigger the abilities when their button is pressed. */
+	uint8 HeldButtons = 0;
+
+	/** Time left of the active blink and stimmy, in milliseconds. */
+	int32 BlinkTimeMS = 0;
+	int32 StimmyTimeMS = 0;
+
+	/** Time left until the abilities can be used again, in milliseconds. */
+	int32 BlinkCooldownMS = 0;
+	int32 StimmyCooldownMS = 0;
+	int32 SlideJumpCooldownMS = 0;
+	int32 GrappleCooldownMS = 0;
+
+	FORCEINLINE bool HasModifier(const uint8 Modifier) const { return (MovementModifiers & (1 << Modifier)) != 0; }
+	FORCEINLINE void AddModifier(const uint8 Modifier) { MovementModifiers |= (1 << Modifier); }
+	FORCEINLINE void RemoveModifier(const uint8 Modifier) { MovementModifiers &= ~(1 << Modifier); }
+
+	FORCEINLINE bool HasState(const EPredictedMovementState State) const { return (StateFlags & State) != 0; }
+	FORCEINLINE void SetState(const EPredictedMovementState State, const bool bEnabled) { StateFlags = bEnabled ? (StateFlags | State) : (StateFlags & ~State); }
+
+	void NetSerialize(const FNetSerializeParams& P);
+
+	void ToString(FAnsiStringBuilderBase& Out) const;
+
+	void Interpolate(const FMyMovementSyncState* From, const FMyMovementSyncState* To, float PCT);
+
+	/**
+	 *	Determines if the predicted state has to be corrected to the authority state.
+	 *	@param AuthorityState the state the server ended the same frame with.
+	 *	@return true if the client has to roll back and resimulate.
+	 */
+	bool ShouldReconcile(const FMyMovementSyncState& AuthorityState) const;
+};
+
+/** State that only changes when gameplay changes it, not every frame. */
+struct FMyMovementAuxState
+{
+	/** Mass of the character, the grapple pull is divided by it. */
+	float Mass = 100.f;
+
+	/** Multiplier applied to every maximum speed on top of the tuning, e.g. for gameplay slows. */
+	float SpeedMultiplier = 1.f;
+
+	void NetSerialize(const FNetSerializeParams& P);
+
+	void ToString(FAnsiStringBuilderBase& Out) const;
+
+	void Interpolate(const FMyMovementAuxState* From, const FMyMovementAuxState* To, float PCT);
+
+	bool ShouldReconcile(const FMyMovementAuxState& AuthorityState) const;
+};
+
+using FMyMovementStateTypes = TNetworkPredictionStateTypes<FMyMovementInputCmd, FMyMovementSyncState, FMyMovementAuxState>;
+
+/**
+ *	The abilities of UMyCharacterMovementComponent as a Network Prediction simulation. Every frame is a pure function of the
+ *	input command and the previous sync and aux state, so the plugin can roll it back and resimulate it. Moves the capsule
+ *	with sweeps but keeps no state of its own, the component is placed at the sync state at the start of every frame.
+ *	This is a simpler kinematic model, not a port of the character movement: the grapple is a hitscan trace instead of the
+ *	hook projectile, there is no crouching and no stepping up onto ledges. The tuning, the walkable floor, the step height,
+ *	the wall reach and the grapple release distance come from UMyMovementTuning so both paths agree on those limits.
+ */
+class FMyMovementSimulation
+{
+public:
+
+	/**
+	 *	Constructor
+	 *	@param InUpdatedComponent the capsule moved by the simulation.
+	 *	@param InTuning the movement tuning shared with UMyCharacterMovementComponent.
+	 */
+	FMyMovementSimulation(UCapsuleComponent* InUpdatedComponent, const UMyMovementTuning* InTuning);
+
+	/**
+	 *	Advances the simulation by one frame.
+	 *	@param TimeStep the duration of the frame.
+	 *	@param Input the input command and the state at the start of the frame.
+	 *	@param Output the state at the end of the frame.
+	 */
+	void SimulationTick(const FNetSimTimeStep& TimeStep, const TNetSimInput<FMyMovementStateTypes>& Input, const TNetSimOutput<FMyMovementStateTypes>& Output);
+
+private:
+
+	/**
+	 *	Sweeps the capsule down looking for a walkable floor.
+	 *	@param MaxDistance how far below the capsule to look.
+	 *	@param OutHit the floor that was found.
+	 *	@return true if a walkable floor is within MaxDistance.
+	 */
+	bool FindFloor(float MaxDistance, FHitResult& OutHit) const;
+
+	/**
+	 *	Looks for a wall that can be ran on to the side of the capsule.
+	 *	@param Right the right vector of the character.
+	 *	@param OutHit the wall that was found.
+	 *	@return true if a wall that can be ran on is next to the capsule.
+	 */
+	bool FindWall(const FVector& Right, FHitResult& OutHit) const;
+
+	/**
+	 *	Determines if the wall being ran on is still next to the capsule.
+	 *	@param WallNormal the normal of the wall.
+	 *	@return true if the wall is still there.
+	 */
+	bool IsNextToWall(const FVector& WallNormal) const;
+
+	/**
+	 *	Accelerates the velocity towards the movement input.
+	 *	@param Sync the state being simulated.
+	 *	@param MovementInput the movement input of the frame.
+	 *	@param MaxSpeed the maximum speed of the current state.
+	 *	@param MaxAcceleration the maximum acceleration of the current state.
+	 *	@param Friction the friction of the current state.
+	 *	@param BrakingDeceleration the deceleration without movement input.
+	 *	@param DeltaSeconds the duration of the frame.
+	 */
+	static void CalcVelocity(FMyMovementSyncState& Sync, const FVector& MovementInput, float MaxSpeed, float MaxAcceleration, float Friction, float BrakingDeceleration, float DeltaSeconds);
+
+	/**
+	 *	Moves the capsule by the velocity of the frame, sliding along anything it hits.
+	 *	@param Sync the state being simulated, the location and velocity are updated.
+	 *	@param DeltaSeconds the duration of the frame.
+	 *	@param bSnapToFloor true to keep the capsule on the floor when walking down slopes and steps.
+	 */
+	void MoveWithCollision(FMyMovementSyncState& Sync, float DeltaSeconds, bool bSnapToFloor) const;
+
+	UCapsuleComponent* UpdatedComponent;
+
+	const UMyMovementTuning* Tuning;
+};
+
+/**
+ *	The Network Prediction model of the custom abilities. The ticking policy and the simulated proxy LOD are taken from
+ *	the Network Prediction project settings, the model is meant for the fixed tick policy with interpolated simulated proxies.
+ */
+class FMyMovementModelDef : public FNetworkPredictionModelDef
+{
+public:
+
+	NP_MODEL_BODY();
+
+	using Simulation = FMyMovementSimulation;
+	using StateTypes = FMyMovementStateTypes;
+	using Driver = UMyMovementPredictionComponent;
+
+	static const TCHAR* GetName() { return TEXT("MyMovement"); }
+	static constexpr int32 GetSortPriority() { return (int32)ENetworkPredictionSortPriority::PreKinematicMovers; }
+};
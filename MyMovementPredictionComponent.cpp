@@ -0,0 +1,73 @@
+#include "Character/Components/MyMovementPredictionComponent.h"
+
+#include "Components/CapsuleComponent.h"
+#include "GameFramework/Pawn.h"
+#include "NetworkPredictionProxyInit.h"
+#include "Character/Components/MyMovementTuning.h"
+
+void UMyMovementPredictionComponent::SetButtonPressed(const EPredictedMovementButton Button, const bool bPressed)
+{
+	HeldButtons = bPressed ? (HeldButtons | Button) : (HeldButtons & ~Button);
+}
+
+void UMyMovementPredictionComponent::InitializeNetworkPredictionProxy()
+{
+	UCapsuleComponent* Capsule = Cast<UCapsuleComponent>(GetOwner()->GetRootComponent());
+	if (!Capsule)
+		return;
+
+	const UMyMovementTuning* Tuning = MovementTuning ? MovementTuning : GetDefault<UMyMovementTuning>();
+	Simulation = MakeUnique<FMyMovementSimulation>(Capsule, Tuning);
+
+	NetworkPredictionProxy.Init<FMyMovementModelDef>(GetWorld(), GetReplicationProxies(), Simulation.Get(), this);
+}
+
+void UMyMovementPredictionComponent::InitializeSimulationState(FMyMovementSyncState* Sync, FMyMovementAuxState* Aux)
+{
+	Sync->Location = GetOwner()->GetActorLocation();
+	Sync->Rotation = GetOwner()->GetActorRotation();
+	Sync->Velocity = FVector::ZeroVector;
+	LastSyncState = *Sync;
+}
+
+void UMyMovementPredictionComponent::ProduceInput(const int32 DeltaTimeMS, FMyMovementInputCmd* Cmd)
+{
+	APawn* Pawn = Cast<APawn>(GetOwner());
+	if (!Pawn)
+		return;
+
+	// Consumed here instead of by a movement component. A frame can run several fixed ticks,
+	// they all get the input of the frame instead of the first one taking it and the rest getting none.
+	if (LatchedInputFrame != GFrameCounter)
+	{
+		LatchedInputFrame = GFrameCounter;
+		LatchedMovementInput = Pawn->ConsumeMovementInputVector().GetClampedToMaxSize(1.f);
+	}
+	
+	Cmd->MovementInput = LatchedMovementInput;
+	Cmd->ControlRotation = Pawn->GetControlRotation();
+	Cmd->Buttons = HeldButtons;
+
+	// Simulate what the server will receive, like the character movement rounds its acceleration
+	Cmd->Quantize();
+}
+
+void UMyMovementPredictionComponent::RestoreFrame(const FMyMovementSyncState* Sync, const FMyMovementAuxState* Aux)
+{
+	SetOwnerTransform(*Sync);
+}
+
+void UMyMovementPredictionComponent::FinalizeFrame(const FMyMovementSyncState* Sync, const FMyMovementAuxState* Aux)
+{
+	SetOwnerTransform(*Sync);
+	LastSyncState = *Sync;
+}
+
+void UMyMovementPredictionComponent::SetOwnerTransform(const FMyMovementSyncState& Sync) const
+{
+	if (USceneComponent* Root = GetOwner()->GetRootComponent())
+	{
+		Root->SetWorldLocationAndRotation(Sync.Location, Sync.Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+		Root->ComponentVelocity = Sync.Velocity;
+	}
+}
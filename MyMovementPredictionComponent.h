@@ -0,0 +1,84 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "NetworkPredictionComponent.h"
+#include "Character/Components/MyMovementPrediction.h"
+#include "MyMovementPredictionComponent.generated.h"
+
+class UMyMovementTuning;
+
+/**
+ *	Drives the custom abilities through the Network Prediction plugin, as an alternative to UMyCharacterMovementComponent.
+ *	The input, sync and aux state of FMyMovementModelDef replace the compressed flags, the state RPCs and the ability timers,
+ *	and the plugin takes care of the fixed tick prediction, the rollbacks and the interpolation of simulated proxies.
+ *	Both backends read the same UMyMovementTuning, so the same inputs can be compared on each of them.
+ *
+ *	Add it to a pawn whose root component is a capsule, instead of a character with UMyCharacterMovementComponent.
+ *	The module has to depend on NetworkPrediction, and the model is meant for these Network Prediction settings in DefaultEngine.ini:
+ *	[/Script/NetworkPrediction.NetworkPredictionSettingsObject]
+ *	Settings=(PreferredTickingPolicy=Fixed,FixedTickFrameRate=60,SimulatedProxyNetworkLOD=Interpolated)
+ */
+UCLASS(ClassGroup = (Movement), Meta = (BlueprintSpawnableComponent))
+class IMPULSE_API UMyMovementPredictionComponent : public UNetworkPredictionComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	/**
+	 *	Presses or releases the button of an ability. Called by the input bindings of the locally controlled pawn,
+	 *	the held buttons are sent with the next input command.
+	 *	@param Button the button of the ability.
+	 *	@param bPressed true if the button is held down.
+	 */
+	void SetButtonPressed(EPredictedMovementButton Button, bool bPressed);
+
+	/** @return the state of the last finalized frame, interpolated on simulated proxies. Read by the animations. */
+	FORCEINLINE const FMyMovementSyncState& GetLastSyncState() const { return LastSyncState; }
+
+	/** Sets the initial state of the simulation from the owner. */
+	void InitializeSimulationState(FMyMovementSyncState* Sync, FMyMovementAuxState* Aux);
+
+	/** Fills the input command of the next frame from the owning pawn. Only called on the locally controlled pawn. */
+	void ProduceInput(const int32 DeltaTimeMS, FMyMovementInputCmd* Cmd);
+
+	/** Moves the owner back to a frame before it is resimulated. */
+	void RestoreFrame(const FMyMovementSyncState* Sync, const FMyMovementAuxState* Aux);
+
+	/** Moves the owner to the final state of the frame. */
+	void FinalizeFrame(const FMyMovementSyncState* Sync, const FMyMovementAuxState* Aux);
+
+protected:
+
+	virtual void InitializeNetworkPredictionProxy() override;
+
+private:
+
+	/**
+	 *	The shared movement tuning used by the simulation.
+	 *	Uses the defaults of UMyMovementTuning if no asset is set.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "My Character Movement|Defaults", Meta = (AllowPrivateAccess = "true"))
+	UMyMovementTuning* MovementTuning;
+
+	/** The simulation of the owner, only created once the capsule of the owner is known. */
+	TUniquePtr<FMyMovementSimulation> Simulation;
+
+	/** Bit mask of the EPredictedMovementButton held down locally. */
+	uint8 HeldButtons = 0;
+
+	/** The movement input consumed from the pawn this frame, sent with every fixed tick of the frame. */
+	FVector LatchedMovementInput = FVector::ZeroVector;
+
+	/** The GFrameCounter LatchedMovementInput was consumed in. */
+	uint64 LatchedInputFrame = MAX_uint64;
+
+	/** See GetLastSyncState(). */
+	FMyMovementSyncState LastSyncState;
+
+	/**
+	 *	Moves the owner to a simulation state.
+	 *	@param Sync the state to move the owner to.
+	 */
+	void SetOwnerTransform(const FMyMovementSyncState& Sync) const;
+};
@@ -0,0 +1,45 @@
+#include "Character/Components/MyMovementTuning.h"
+
+void UMyMovementTuning::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	BuildSpeedTables();
+}
+
+void UMyMovementTuning::PostLoad()
+{
+	Super::PostLoad();
+
+	BuildSpeedTables();
+}
+
+#if WITH_EDITOR
+void UMyMovementTuning::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	BuildSpeedTables();
+}
+#endif
+
+void UMyMovementTuning::BuildSpeedTables()
+{
+	for (int32 Stimmy = 0; Stimmy < 2; ++Stimmy)
+	{
+		const float SpeedMultiplier = Stimmy ? StimmySpeedMultiplier : 1.f;
+
+		MaxSpeedTable[SPEED_Run][Stimmy] = DefaultMaxRunSpeed * SpeedMultiplier;
+		MaxSpeedTable[SPEED_Sprint][Stimmy] = DefaultMaxSprintSpeed * SpeedMultiplier;
+		MaxSpeedTable[SPEED_Crouch][Stimmy] = DefaultMaxWalkSpeedCrouched * SpeedMultiplier;
+		MaxSpeedTable[SPEED_Slide][Stimmy] = MaxSlideSpeed * SpeedMultiplier;
+		MaxSpeedTable[SPEED_WallRun][Stimmy] = WallRunSpeed * SpeedMultiplier;
+
+		// The stimmy only affects speed, sliding is always started while sprinting
+		MaxAccelerationTable[SPEED_Run][Stimmy] = DefaultMaxRunAcceleration;
+		MaxAccelerationTable[SPEED_Sprint][Stimmy] = DefaultMaxSprintAcceleration;
+		MaxAccelerationTable[SPEED_Crouch][Stimmy] = DefaultMaxRunAcceleration;
+		MaxAccelerationTable[SPEED_Slide][Stimmy] = DefaultMaxSprintAcceleration;
+		MaxAccelerationTable[SPEED_WallRun][Stimmy] = DefaultMaxRunAcceleration;
+	}
+}
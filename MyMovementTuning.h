@@ -0,0 +1,237 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "MyMovementTuning.generated.h"
+
+/**
+ *	The movement states that have their own maximum speed and acceleration.
+ *	SPEED_Run - running on the ground or falling.
+ *	SPEED_Sprint - sprinting forward on the ground.
+ *	SPEED_Crouch - crouched on the ground.
+ *	SPEED_Slide - sliding on the ground.
+ *	SPEED_WallRun - running along a wall.
+ */
+enum EMovementSpeedState : uint8
+{
+	SPEED_Run,
+	SPEED_Sprint,
+	SPEED_Crouch,
+	SPEED_Slide,
+	SPEED_WallRun,
+	SPEED_MAX
+};
+
+/**
+ *	Immutable movement tuning shared by every UMyCharacterMovementComponent that references it.
+ *	The effective speed and acceleration of every movement state, with and without the stimmy, is precomputed
+ *	once when the asset is loaded so the movement component only has to do a table lookup.
+ */
+UCLASS(BlueprintType)
+class IMPULSE_API UMyMovementTuning : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	/** The maximum ground speed while running. Also determines maximum lateral speed when falling. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Defaults: Grounded")
+	float DefaultMaxRunSpeed = 550.0f;
+
+	/** The default maximum acceleration while running. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Defaults: Grounded")
+	float DefaultMaxRunAcceleration = 10000.0f;
+
+	/**
+	 * Setting that affects movement control. Higher values allow faster changes in direction.
+	 * If bUseSeparateBrakingFriction is false, also affects the ability to stop more quickly when braking (whenever Acceleration is zero), where it is multiplied by BrakingFrictionFactor.
+	 * When braking, this property allows you to control how much friction is applied when moving across the ground, applying an opposing force that scales with current velocity.
+	 * This can be used to simulate slippery surfaces such as ice or oil by changing the value (possibly based on the material pawn is standing on).
+	 * @see BrakingDecelerationWalking, BrakingFriction, bUseSeparateBrakingFriction, BrakingFrictionFactor
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Defaults: Grounded")
+	float DefaultGroundFriction = 5.f;
+
+	/**
+	 * Deceleration when walking and not applying acceleration. This is a constant opposing force that directly lowers velocity by a constant value.
+	 * @see GroundFriction, MaxAcceleration
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Defaults: Grounded")
+	float DefaultBrakingDecelerationWalking = 10000.f;
+
+	/** The maximum height of a step the character can walk up or down without falling. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Defaults: Grounded")
+	float DefaultMaxStepHeight = 45.f;
+
+	/** The minimum Z of a surface normal that can be walked on. Surfaces flatter than this are floors, steeper ones are walls. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Defaults: Grounded", Meta = (ClampMin = "0", ClampMax = "1"))
+	float DefaultWalkableFloorZ = 0.71f;
+
+	/** Custom gravity scale. Gravity is multiplied by this amount for the character. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Defaults: InAir")
+	float DefaultGravityScale = 1.75f;
+
+	/** Initial velocity (instantaneous vertical acceleration) when jumping. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Defaults: InAir")
+	float DefaultJumpZVelocity = 550.f;
+
+	/**
+	 * When falling, amount of lateral movement control available to the character.
+	 * 0 = no control, 1 = full control at max speed of MaxWalkSpeed.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Defaults: InAir")
+	float DefaultAirControl = 0.2f;
+
+	/**
+	 * When falling, multiplier applied to AirControl when lateral velocity is less than AirControlBoostVelocityThreshold.
+	 * Setting this to zero will disable air control boosting. Final result is clamped at 1.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Defaults: InAir")
+	float DefaultAirControlBoostMultiplier = 0.f;
+
+	/**
+	 * When falling, if lateral velocity magnitude is less than this value, AirControl is multiplied by AirControlBoostMultiplier.
+	 * Setting this to zero will disable air control boosting.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Defaults: InAir")
+	float DefaultAirControlBoostVelocityThreshold = 0.f;
+
+	/**
+	 * Friction to apply to lateral air movement when falling.
+	 * If bUseSeparateBrakingFriction is false, also affects the ability to stop more quickly when braking (whenever Acceleration is zero).
+	 * @see BrakingFriction, bUseSeparateBrakingFriction
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Defaults: InAir")
+	float DefaultFallingLateralFriction = 0.1f;
+
+	/** The default maximum ground speed when sprinting. Also determines the maximum lateral speed while falling. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Sprinting")
+	float DefaultMaxSprintSpeed = 825.0f;
+
+	/** The default maximum acceleration when sprinting. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Sprinting")
+	float DefaultMaxSprintAcceleration = 10000.0f;
+
+	/** The default maximum ground speed while walking and when crouched. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crouching")
+	float DefaultMaxWalkSpeedCrouched = 300.f;
+
+	/** The maximum ground speed when sliding. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Sliding")
+	float MaxSlideSpeed = 1300.f;
+
+	/** The amount of vertical room between the two line traces when checking if the character is still on the wall. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Wall Running")
+	float LineTraceVerticalTolerance = 10.0f;
+
+	/** How far to the side of the character a wall is looked for when starting and keeping a wall run. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Wall Running")
+	float WallRunTraceReach = 100.f;
+
+	/** The maximum speed while wall running. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Wall Running")
+	float WallRunSpeed = 1200.0f;
+
+	/** The force applied horizontally when jumping off of a wall. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Wall Running")
+	float HorizontalWallJumpOffForce = 400.f;
+
+	/** The force applied vertically when jumping off of a wall. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Wall Running")
+	float VerticalWallJumpOffForce = 600.f;
+
+	/** Amount of force applied in the direction of the blink. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Blink")
+	float BlinkStrength = 10000.f;
+
+	/** The duration of the blink. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Blink")
+	float BlinkDuration = 0.15f;
+
+	/** The time it takes to be able to reuse the blink. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Blink")
+	float BlinkCooldown = 1.f;
+
+	/** Multiplier applied to all movements while the stimmy is active. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Stimmy")
+	float StimmySpeedMultiplier = 1.5f;
+
+	/** The duration of the stimmy. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Stimmy")
+	float StimmyDuration = 10.f;
+
+	/** The time it takes to be able to reuse the stimmy. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Stimmy")
+	float StimmyCooldown = 8.f;
+
+	/** The value of the gravity scale only while slide jumping. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "SlideJump")
+	float SlideJumpGravityScale = 2.5f;
+
+	/** The horizontal force applied when slide jumping. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "SlideJump")
+	float HorizontalSlideJumpForce = 1500.f;
+
+	/** The vertical force applied when slide jumping. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "SlideJump")
+	float VerticalSlideJumpForce = 2000.f;
+
+	/** The time it takes to be able to slide jump again after starting the ability. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "SlideJump")
+	float SlideJumpCooldown = 6.f;
+
+	/** The maximum distance the grapple hook travels before breaking. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Grapple Hook")
+	float GrappleDistance = 4000.f;
+
+	/** The grapple hook is released once the player gets this close to it. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Grapple Hook")
+	float GrappleReleaseDistance = 250.f;
+
+	/** The force applied to the player by the grapple. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Grapple Hook")
+	float GrapplePullForce = 200000.f;
+
+	/** The instantaneous velocity of the player when the grapple attaches. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Grapple Hook")
+	float InstantaneousVelocityFromGrapple = 1200.f;
+
+	/** The time it takes to be able to use the grapple again after it is destroyed. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Grapple Hook")
+	float GrappleCooldown = 8.f;
+
+	/**
+	 *	Returns the precomputed maximum speed of a movement state.
+	 *	@param State the movement state.
+	 *	@param bStimmy true if the stimmy is currently active.
+	 *	@return the maximum speed of the state, including the stimmy multiplier if active.
+	 */
+	FORCEINLINE float GetMaxSpeed(const EMovementSpeedState State, const bool bStimmy) const { return MaxSpeedTable[State][bStimmy]; }
+
+	/**
+	 *	Returns the precomputed maximum acceleration of a movement state.
+	 *	@param State the movement state.
+	 *	@param bStimmy true if the stimmy is currently active.
+	 *	@return the maximum acceleration of the state.
+	 */
+	FORCEINLINE float GetMaxAcceleration(const EMovementSpeedState State, const bool bStimmy) const { return MaxAccelerationTable[State][bStimmy]; }
+
+	virtual void PostInitProperties() override;
+
+	virtual void PostLoad() override;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+
+	/** Builds the effective speed and acceleration tables from the tuning values. */
+	void BuildSpeedTables();
+
+	/** The maximum speed of each movement state, indexed by [State][bStimmy]. */
+	float MaxSpeedTable[SPEED_MAX][2];
+
+	/** The maximum acceleration of each movement state, indexed by [State][bStimmy]. */
+	float MaxAccelerationTable[SPEED_MAX][2];
+};